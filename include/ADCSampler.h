@@ -0,0 +1,163 @@
+/**
+ * @file ADCSampler.h
+ * @brief Sample the supply and antenna levels and stream them over UART1
+ *
+ * The ADC isr converts the channels of samplerChannels in turn, each
+ * conversion started right after the last one. Every SamplerOversample
+ * rounds, the sums are decimated into a frame of one 10 bit sample per
+ * channel and put into the sample ring.
+ *
+ * While streaming, samples are packed 4 in 5 bytes: the high 8 bits of each
+ * sample, then a byte holding the low 2 bits of the first one in bits 1:0,
+ * the second one in bits 3:2 and so on. The stream starts with
+ * SamplerStreamMagic, the channel count and SamplerOversampleBits.
+ *
+ * Outside a stream the sampler is stopped, refreshSamplerLevels() takes a
+ * single frame when a fresh level is needed, in about 3 ms at SPEED 540.
+ *
+ * Rates with 2 channels and SamplerOversample 32 at 11.0592 MHz:
+ *
+ * | SPEED | clocks | conversions/s | samples/s per channel | CPU load |
+ * | ----- | ------ | ------------- | --------------------- | -------- |
+ * | 540   | 540    | 20480         | 320                   | ~20%     |
+ * | 360   | 360    | 30720         | 480                   | ~30%     |
+ * | 180   | 180    | 61440         | 960                   | ~60%     |
+ * | 90    | 90     | 122880        | 1920                  | saturated|
+ *
+ * CPU load assumes about 110 clocks per isr. At 9600 baud the stream
+ * carries at most 768 samples/s, i.e. 384 per channel, so only SPEED 540
+ * streams without dropping frames.
+ */
+#pragma once
+#include "BoardBase.h"
+#include "STC/ADC/ADC.h"
+#include "STC/Interrupt.h"
+#include "STC/UART/TxQueue.h"
+#include "stdint.h"
+
+/**
+ * @brief Conversion time used by the sampler
+ */
+#define SamplerSpeed ADCSpeed_540
+
+/**
+ * @brief Rounds summed into a sample, as a power of 2
+ */
+#define SamplerOversampleBits 5
+#define SamplerOversample (1 << SamplerOversampleBits)
+
+#define SamplerChannelCount 2
+
+/**
+ * @brief Size of the sample ring, must be a power of 2 and a multiple of SamplesPerGroup
+ */
+#define SampleRingSize 32
+
+/**
+ * @brief Samples packed in a group of SampleGroupSize bytes
+ */
+#define SamplesPerGroup 4
+#define SampleGroupSize 5
+
+/**
+ * @brief Request to start or stop streaming
+ */
+#define SamplerStreamRequest '!'
+
+/**
+ * @brief Starts a stream, followed by channel count and oversample bits
+ */
+#define SamplerStreamMagic 'S'
+#define SamplerHeaderSize 3
+
+extern __code ADCChannel_t samplerChannels[SamplerChannelCount];
+
+extern __xdata uint16_t sampleRing[SampleRingSize];
+
+extern uint8_t sampleHead, sampleTail;
+/**
+ * @brief Frames dropped because the ring was full
+ */
+extern uint8_t samplesDropped;
+
+/**
+ * @brief Sum of the current round of each channel
+ */
+extern uint16_t samplerSums[SamplerChannelCount];
+/**
+ * @brief Last decimated sample of each channel
+ */
+extern uint16_t samplerLevels[SamplerChannelCount];
+
+/**
+ * @brief Index of the channel being converted
+ */
+extern uint8_t samplerChannel;
+extern uint8_t samplerRound;
+extern uint8_t samplerRunning;
+extern uint8_t samplerStreaming;
+/**
+ * @brief Set while a frame is taken for refreshSamplerLevels()
+ */
+extern uint8_t samplerOneShot;
+/**
+ * @brief Set once that frame is decimated
+ */
+extern uint8_t samplerFresh;
+
+/**
+ * @brief Power on the ADC, call it at least 1 ms before startSampler()
+ */
+void initSampler();
+
+/**
+ * @brief Start converting from the first channel
+ */
+void startSampler();
+
+/**
+ * @brief Stop after the conversion in progress
+ */
+inline void stopSampler()
+{
+    samplerRunning = 0;
+}
+
+/**
+ * @brief Decimate the sums into a frame and put it into the ring while streaming
+ */
+void pushSampleFrame();
+
+/**
+ * @brief Accumulate the result and start the next conversion, call it in isr on ADC_FLAG
+ */
+void onADCDone();
+
+/**
+ * @brief Read the last level of a channel, safe outside of the ADC isr
+ *
+ * @param index index of the channel in samplerChannels
+ * @return 10 bit level
+ */
+uint16_t readSamplerLevel(uint8_t index);
+
+/**
+ * @brief Have samplerLevels taken after the call, call it from the main loop until it returns non-zero
+ *
+ * A stream keeps them fresh, otherwise a single frame is taken.
+ *
+ * @return non-zero once the levels are fresh
+ */
+uint8_t refreshSamplerLevels();
+
+/**
+ * @brief Start or stop streaming, call it when the TX queue has a free descriptor
+ *
+ * @return non-zero if done, the stream isn't started unless its whole header is queued
+ */
+uint8_t toggleSampleStream();
+
+/**
+ * @brief Send a group of samples if there are enough, call it from the main loop
+ */
+void pumpSamples();
\ No newline at end of file
@@ -1,71 +1,46 @@
 #pragma once
+#include "RecordCodec.h"
+#include "RecordHistory.h"
+#include "RecordStore.h"
 #include "STC/IAP/IAP.h"
-#include "STC/UART/UART.h"
+#include "STC/UART/TxQueue.h"
+#include "WriteBackCache.h"
 
-#define SavedDataAddr 0x0000
+/**
+ * @brief Every response is a prefix of one of them
+ */
+#define AlphabetLen 26
+extern const __code char lowerAlphabet[AlphabetLen + 1];
+extern const __code char upperAlphabet[AlphabetLen + 1];
+extern const __code char newLine[2];
 
 /**
- * @brief Last sent data buffer
+ * @brief Saved data decoded at boot if it is not a prefix of an alphabet
  */
-char sentData[27];
+extern __xdata uint8_t savedData[AlphabetLen];
 
 /**
- * @brief Save data to EEPROM
+ * @brief Save data to EEPROM, don't call it in isr
+ *
+ * The record log is written back lazily, the record is staged for the
+ * history as well, both are committed by stepCommit().
  *
- * @param data data to save
+ * @param record encoded data to save
+ * @param size size of the record
  */
-void saveSentData(char* data)
-{
-    writeIAPAddr(SavedDataAddr);
-    doIAPOp(Erase);
-    char ch;
-    while ((ch = *data++) != '\0') {
-        writeToIAP(ch);
-        incIAPAddr();
-    }
-    writeToIAP('\0');
-}
+void saveSentData(const uint8_t* record, uint8_t size);
 
 /**
  * @brief Send data saved in errpom
+ *
+ * Only the encoded record is read, a prefix of an alphabet is streamed from
+ * code memory, so the time to ready doesn't grow with its length.
  */
-void sendSavedData()
-{
-    writeIAPAddr(SavedDataAddr);
-    // Nothing saved
-    if (readFromIAP() == 0xFF) return;
-    char ch;
-    while ((ch = readFromIAP()) != '\0') {
-        sendData(Port1, ch);
-        incIAPAddr();
-    }
-    sendData(Port1, '\n');
-}
+void sendSavedData();
 
 /**
  * @brief Send alpha char from 'a'/'A' to the specific end char
  *
  * @param endChar end char
  */
-void sendAlpha(char endChar)
-{
-    uint8_t len;
-    char    startChar;
-    if (endChar <= 'z' && endChar >= 'a')
-        startChar = 'a';
-    else if (endChar <= 'Z' && endChar >= 'A')
-        startChar = 'A';
-    else
-        return;
-
-    // With one more \0 char
-    len = endChar - (startChar - 1) + 1;
-    for (char i = startChar; i <= endChar; i++) {
-        sendData(Port1, i);
-        sentData[i - startChar] = i;
-    }
-    sendData(Port1, '\n');
-
-    sentData[len] = '\0';
-    saveSentData(sentData);
-}
\ No newline at end of file
+void sendAlpha(char endChar);
\ No newline at end of file
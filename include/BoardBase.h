@@ -1,8 +1,34 @@
 #pragma once
 #include "STC/STCBase.h"
 
+/**
+ * @brief Set to 1 to clock UART1 from Timer1 for simulators without BRT, see tools/ucsim_pty.py
+ */
+#ifndef SimBaudTimer1
+#define SimBaudTimer1 0
+#endif
+
 /**
  * @brief Define Led Pins
  */
 SBIT(Led_P1, _P1, 0);
-SBIT(Led_P4, _P4, 4);
\ No newline at end of file
+SBIT(Led_P4, _P4, 4);
+
+/**
+ * @brief Define flow control Pins of UART1, both active low
+ *
+ * Rts_P3 tells the peer it may send, Cts_P3 tells this node it may send
+ */
+SBIT(Rts_P3, _P3, 6);
+SBIT(Cts_P3, _P3, 7);
+
+/**
+ * @brief Define analog inputs of the board
+ */
+#define SupplyADCChannel ADCChannel1
+#define AntennaADCChannel ADCChannel2
+
+/**
+ * @brief Define chip select Pin of the SPI NOR flash, active low
+ */
+SBIT(FlashCs_P1, _P1, 4);
\ No newline at end of file
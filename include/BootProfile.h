@@ -0,0 +1,76 @@
+/**
+ * @file BootProfile.h
+ * @brief Time spent in each phase of the boot
+ *
+ * The PCA counter is started by _sdcc_external_startup() right after reset,
+ * and the counter is recorded at the end of each phase. A phase took
+ * (its mark - the mark before) * 12 clocks, the counter wraps after 71 ms.
+ */
+#pragma once
+#include "STC/PCA/PCA.h"
+#include "STC/UART/TxQueue.h"
+#include "stdint.h"
+
+/**
+ * @brief Set to 1 to skip the startup code of SDCC, see _sdcc_external_startup()
+ */
+#ifndef FastBoot
+#define FastBoot 1
+#endif
+
+typedef enum BootPhase {
+    /**
+     * @brief Startup code, from reset to main()
+     */
+    BootStartup,
+    /**
+     * @brief Registers, soft timers and PCA
+     */
+    BootCore,
+    /**
+     * @brief Config store and record log scanned, LVD enabled
+     */
+    BootStores,
+    /**
+     * @brief UART1 receiving and the saved record queued
+     */
+    BootReady,
+    /**
+     * @brief Initialization deferred after the node is responsive
+     */
+    BootDeferred,
+    BootPhaseCount
+} BootPhase_t;
+
+/**
+ * @brief Request to dump the profile
+ */
+#define BootProfileRequest '@'
+
+/**
+ * @brief Starts a dump, followed by phase count and a little endian mark per phase
+ */
+#define BootProfileMagic 'B'
+#define BootProfileHeaderSize 2
+
+/**
+ * @brief PCA counter at the end of each phase
+ */
+extern __xdata uint16_t bootProfile[BootPhaseCount];
+
+/**
+ * @brief Record the end of a phase
+ *
+ * @param phase phase that ends
+ */
+inline void markBoot(BootPhase_t phase)
+{
+    bootProfile[phase] = readPCACounter();
+}
+
+/**
+ * @brief Send the profile through the TX queue
+ *
+ * @return non-zero if queued
+ */
+uint8_t dumpBootProfile();
\ No newline at end of file
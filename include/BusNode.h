@@ -0,0 +1,65 @@
+/**
+ * @file BusNode.h
+ * @brief Node of a multi-drop bus using the 9th bit as address flag
+ *
+ * An address frame has the 9th bit set. While SM2 is set, the hardware
+ * compares address frames with SADDR/SADEN and sets RI only for this node
+ * or the broadcast address, data frames to other nodes never wake the isr.
+ * Once addressed, SM2 is cleared to receive the data frames that follow,
+ * until an address frame selects another node.
+ */
+#pragma once
+#include "ConfigStore.h"
+#include "STC/STCBase.h"
+#include "stdint.h"
+
+/**
+ * @brief Set to 1 to run UART1 as a node of an addressed bus
+ */
+#ifndef AddressedBusMode
+#define AddressedBusMode 0
+#endif
+
+/**
+ * @brief Address used when no one is stored in config
+ */
+#define DefaultNodeAddr 0x01
+
+/**
+ * @brief Address frame selecting every node
+ */
+#define BusBroadcastAddr 0xFF
+
+/**
+ * @brief Request to change the node address, followed by the new address in the same frame
+ *
+ * Send it to this node only, every node takes the address of a broadcast.
+ */
+#define NodeAddrRequest '~'
+
+/**
+ * @brief Address of this node
+ */
+extern uint8_t nodeAddr;
+
+/**
+ * @brief Load the node address from config and set up address recognition
+ *
+ * Call it after initConfigStore()
+ */
+void initBusNode();
+
+/**
+ * @brief Store a new node address, takes effect at once, don't call it in isr
+ *
+ * @param addr new address, ignored if it is the broadcast address
+ */
+void setNodeAddr(uint8_t addr);
+
+/**
+ * @brief Handle a received frame of UART1, call it in isr on RI
+ *
+ * @param data received data
+ * @return non-zero if it is a data frame to this node
+ */
+uint8_t acceptBusFrame(uint8_t data);
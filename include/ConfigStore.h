@@ -0,0 +1,114 @@
+/**
+ * @file ConfigStore.h
+ * @brief Key-value config store on EEPROM
+ *
+ * Entries are appended to the active sector, a newer entry of the same key
+ * shadows the older one. When the active sector is full, the newest entry of
+ * every key is copied into the spare sector, which then becomes active.
+ *
+ * Sector layout: [generation] [entry] [entry] ... [0xFF ...]
+ * Entry layout:  [key] [len] [value ...] [commit mark]
+ *
+ * initConfigStore() scans the active sector once and remembers where the
+ * newest entry of every key is, so getConfig() never scans the flash.
+ */
+#pragma once
+#include "EEPROMCommitter.h"
+#include "STC/IAP/IAP.h"
+#include "stdint.h"
+
+/**
+ * @brief Sectors used by the config store, the active one swaps on compaction
+ */
+#define ConfigSectorA 0x0200
+#define ConfigSectorB 0x0400
+
+/**
+ * @brief Max length of a value in bytes
+ */
+#define ConfigMaxValueSize 16
+
+/**
+ * @brief Written after the value, an entry without it is discarded
+ */
+#define ConfigCommitMark 0x00
+
+/**
+ * @brief Keys of the config store, must be less than ConfigKeyCount
+ */
+typedef enum ConfigKey {
+    KeyBaudRate,
+    KeyNodeAddr,
+    KeyCalibration,
+    /**
+     * @brief Size of the index, keys up to 16 are reserved
+     */
+    ConfigKeyCount = 16
+} ConfigKey_t;
+
+/**
+ * @brief Offset of the newest entry of every key in the active sector, 0 if not found
+ */
+extern __xdata uint16_t configIndex[ConfigKeyCount];
+
+/**
+ * @brief Address of the active sector
+ */
+extern uint16_t configSector;
+/**
+ * @brief Offset of the first free byte in the active sector
+ */
+extern uint16_t configFree;
+/**
+ * @brief Generation of the active sector, the newer sector has the larger one
+ */
+extern uint8_t configGen;
+
+/**
+ * @brief Get the generation next to gen, 0xFF means an erased sector
+ */
+#define NextConfigGen(gen) ((uint8_t)((gen) + 1) == 0xFF ? 0 : (uint8_t)((gen) + 1))
+
+/**
+ * @brief Build the index of the active sector
+ */
+void indexConfigSector();
+
+/**
+ * @brief Select the active sector and build its index, call it once at boot
+ */
+void initConfigStore();
+
+/**
+ * @brief Get value of the key
+ *
+ * @param key key of the value
+ * @param value buffer to hold the value
+ * @param maxLen size of the buffer
+ * @return length of the value, 0 if not found
+ */
+uint8_t getConfig(ConfigKey_t key, uint8_t* value, uint8_t maxLen);
+
+/**
+ * @brief Copy bytes between two addresses of EEPROM
+ *
+ * @param from address to copy from
+ * @param to address to copy to, must be erased before
+ * @param len length to copy
+ */
+void copyIAP(uint16_t from, uint16_t to, uint8_t len);
+
+/**
+ * @brief Copy the newest entry of every key into the spare sector and make it active
+ */
+void compactConfigStore();
+
+/**
+ * @brief Set value of the key, don't call it in isr
+ *
+ * @param key key of the value
+ * @param value value to set
+ * @param len length of the value
+ * @return non-zero if stored
+ */
+uint8_t setConfig(ConfigKey_t key, const uint8_t* value, uint8_t len);
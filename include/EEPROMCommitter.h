@@ -0,0 +1,216 @@
+/**
+ * @file EEPROMCommitter.h
+ * @brief Commit records to EEPROM without blocking the caller
+ *
+ * A record is (optionally erased and) programmed one IAP operation per stepCommit() call,
+ * so interrupts get serviced between two operations. Requests to the same
+ * record are coalesced, only the newest payload gets committed.
+ *
+ * The CPU stalls during an erase and a receiver would overrun, so
+ * erasePauseHook is polled until the peer is paused, and eraseResumeHook
+ * lets it send again, e.g. pauseRxForErase() of UART1.
+ *
+ * On low voltage, urgeCommit() finishes every pending record at once, then
+ * the records commitUrgeHook queues, e.g. a record cached in RAM.
+ */
+#pragma once
+#include "STC/IAP/IAP.h"
+#include "STC/Interrupt.h"
+#include "stdint.h"
+
+/**
+ * @brief Max size of a record in bytes
+ */
+#define CommitRecordSize 28
+
+/**
+ * @brief How many different records could be pending at the same time
+ */
+#define CommitQueueSize 2
+
+/**
+ * @brief Worst-case time to commit a record of len bytes in microsecond
+ */
+#define CommitBudgetUs(len) (IAPEraseTimeUs + (uint32_t)(len)*IAPProgramTimeUs)
+
+/**
+ * @brief Worst-case time of urgeCommit() in microsecond, the pending records and the one of commitUrgeHook
+ *
+ * Vcc must hold above the working voltage for this long after LVD fires
+ */
+#define UrgeCommitBudgetUs ((CommitQueueSize + 1) * CommitBudgetUs(CommitRecordSize))
+
+/**
+ * @brief Called when the record at addr has been committed
+ */
+typedef void (*CommitCallback_t)(uint16_t addr);
+
+/**
+ * @brief Called once every pending record is committed urgently, may queue one more record
+ */
+typedef void (*CommitUrgeHook_t)();
+
+/**
+ * @brief Polled before an erase until it returns non-zero, not waited for on low voltage
+ *
+ * @param first non-zero on the first call for an erase
+ * @return non-zero once the erase may stall the CPU
+ */
+typedef uint8_t (*ErasePauseHook_t)(uint8_t first);
+
+/**
+ * @brief Called after an erase paused by ErasePauseHook_t
+ */
+typedef void (*EraseResumeHook_t)();
+
+typedef enum CommitState {
+    CommitIdle,
+    /**
+     * @brief Wait for the peer to pause before erasing
+     */
+    CommitPause,
+    /**
+     * @brief Erase the sector of the record
+     */
+    CommitErase,
+    /**
+     * @brief Program one byte of the record per step
+     */
+    CommitProgram
+} CommitState_t;
+
+typedef struct CommitSlot
+{
+    /**
+     * @brief Address of the record, must be aligned to a sector if erase is set
+     */
+    uint16_t         addr;
+    uint8_t          len;
+    /**
+     * @brief Erase the sector before programming, or the bytes must be erased already
+     */
+    uint8_t          erase;
+    /**
+     * @brief Set when the payload is newer than the one in EEPROM
+     */
+    uint8_t          pending;
+    CommitCallback_t onDone;
+    uint8_t          data[CommitRecordSize];
+} CommitSlot_t;
+
+extern __xdata CommitSlot_t commitSlots[CommitQueueSize];
+
+extern CommitState_t commitState;
+/**
+ * @brief Index of the slot being committed
+ */
+extern uint8_t commitSlot;
+/**
+ * @brief Offset of the next byte to program
+ */
+extern uint8_t commitOffset;
+/**
+ * @brief Set while the main loop holds the IAP registers
+ */
+extern uint8_t iapHeld;
+/**
+ * @brief Set when every pending record should be committed at once
+ */
+extern uint8_t commitUrgent;
+/**
+ * @brief Set while committing urgently, the peer is not waited for
+ */
+extern uint8_t commitRushed;
+/**
+ * @brief Set once erasePauseHook is called for the erase of the active slot
+ */
+extern uint8_t commitPausing;
+/**
+ * @brief Set by the owner of a record held in RAM, could be null
+ */
+extern CommitUrgeHook_t commitUrgeHook;
+/**
+ * @brief Set both before the first erase, or none to erase at once
+ */
+extern ErasePauseHook_t  erasePauseHook;
+extern EraseResumeHook_t eraseResumeHook;
+
+/**
+ * @brief Empty the queue, call it once at boot as XRAM is not cleared by FastBoot
+ */
+void initCommitter();
+
+/**
+ * @brief Check if the slot is being committed
+ *
+ * @param i index of the slot
+ * @return non-zero if active
+ */
+inline int isCommitActive(uint8_t i)
+{
+    return commitState != CommitIdle && commitSlot == i;
+}
+
+/**
+ * @brief Check if there is nothing to commit
+ *
+ * @return non-zero if idle
+ */
+int isCommitIdle();
+
+/**
+ * @brief Queue a record to commit, safe to call in isr
+ *
+ * @param addr address of the record, must be aligned to a sector if erase is set
+ * @param data payload of the record
+ * @param len length of the payload
+ * @param erase non-zero to erase the sector before programming
+ * @param onDone called after committed, could be null
+ * @return non-zero if queued, zero if the queue is full or the payload is too long
+ */
+uint8_t requestCommit(uint16_t addr, const uint8_t* data, uint8_t len, uint8_t erase, CommitCallback_t onDone);
+
+/**
+ * @brief Erase a sector with the peer paused, blocks until done, don't call it in isr
+ *
+ * @param addr address in the sector
+ */
+void eraseSector(uint16_t addr);
+
+/**
+ * @brief Do at most one IAP operation
+ */
+void doCommitStep();
+
+/**
+ * @brief Hold the IAP registers in the main loop
+ *
+ * urgeCommit() won't touch IAP until releaseIAP() is called
+ */
+inline void holdIAP()
+{
+    iapHeld = 1;
+}
+
+/**
+ * @brief Commit every pending record, then the one queued by commitUrgeHook
+ */
+void commitUrgently();
+
+/**
+ * @brief Release the IAP registers, doing urgent commits deferred meanwhile
+ */
+void releaseIAP();
+
+/**
+ * @brief Do at most one IAP operation, call it from the main loop
+ */
+void stepCommit();
+
+/**
+ * @brief Commit every pending record synchronously, call it from the LVD isr
+ *
+ * Takes at most UrgeCommitBudgetUs. If the main loop holds the IAP
+ * registers, the work is left to releaseIAP() to keep them consistent.
+ */
+void urgeCommit();
@@ -2,46 +2,76 @@
  * @file LedBlinker.h
  * @author Windmill_City
  * @brief Blink Led in specific routines
- * @version 0.1
+ * @version 0.2
  * @date 2021-09-15
  *
  * @copyright Copyright (c) 2021
  *
+ * Routines are tables of steps in code memory, timed by PCA module 1 in soft
+ * timer mode. The CPU only steps in when the compare matches, at a step
+ * transition or every LedMaxChunkTicks of a long step.
+ *
+ * Led_P1 is not a CEXx pin, so the PWM mode of the module can't drive it and
+ * steps are on/off only.
  */
 #pragma once
 #include "BoardBase.h"
+#include "STC/PCA/PCA.h"
 #include "stdint.h"
 
 #define Led Led_P1
 
-int isLedOn()
-{
-    return !Led;
-}
+/**
+ * @brief PCA module timing the routine
+ */
+#define LedModule PCAModule1
+
+/**
+ * @brief Longest time between two matches in PCA ticks
+ */
+#define LedMaxChunkTicks 0xFF00
 
 /**
- * @brief Call this method every one microsecond to trigger updates
+ * @brief How many PCA ticks passes in ms millisecond
  */
-void onSysTickOneMs()
+#define MsToPCATicks(ms) ((uint32_t)PCAClock / 1000 * (ms))
+
+typedef struct LedStep
 {
+    uint8_t  on;
     /**
-     * @brief Remain lighting time in microsecond
-     */
-    static uint16_t remainLightingTime = 0;
-    /**
-     * @brief Remain off time in microsecond
+     * @brief Duration of the step in PCA ticks
      */
-    static uint16_t remainOffTime = 1000;
-    if (isLedOn()) {
-        if (!--remainLightingTime) {
-            Led           = 1;
-            remainOffTime = 1000;
-        }
-    }
-    else {
-        if (!--remainOffTime) {
-            Led                = 0;
-            remainLightingTime = 1000;
-        }
-    }
-}
\ No newline at end of file
+    uint32_t ticks;
+} LedStep_t;
+
+/**
+ * @brief Light 1s, then off 1s
+ */
+#define BlinkRoutineLen 2
+extern const __code LedStep_t blinkRoutine[BlinkRoutineLen];
+
+extern const __code LedStep_t* ledRoutine;
+extern uint8_t                 ledRoutineLen;
+extern uint8_t                 ledStep;
+/**
+ * @brief Remain ticks of the current step
+ */
+extern uint32_t ledRemainTicks;
+/**
+ * @brief Compare value of the next match
+ */
+extern uint16_t ledCompare;
+
+/**
+ * @brief Call it in isr on CCF of LedModule
+ */
+void onLedMatch();
+
+/**
+ * @brief Play a routine repeatedly, call it after the PCA is started
+ *
+ * @param routine steps of the routine
+ * @param len count of steps
+ */
+void playLedRoutine(const __code LedStep_t* routine, uint8_t len);
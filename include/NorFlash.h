@@ -0,0 +1,123 @@
+/**
+ * @file NorFlash.h
+ * @brief Commands of a standard SPI NOR flash, e.g. W25Qxx
+ *
+ * Reads and short commands are blocking. A page program sends its header
+ * blocking and streams the payload through the SPI isr, so the CPU keeps
+ * running while the payload is shifted out and while the chip programs.
+ */
+#pragma once
+#include "BoardBase.h"
+#include "STC/SPI/SPI.h"
+#include "stdint.h"
+
+#define NorPageSize 256
+#define NorSectorSize 4096UL
+
+/**
+ * @brief SPI clock, the payload isr takes about 60 clocks per byte so DIV_4 would starve the CPU
+ */
+#define NorSPIClock SPIClock_DIV_16
+
+#define NorCmdWriteEnable 0x06
+#define NorCmdReadStatus 0x05
+#define NorCmdRead 0x03
+#define NorCmdPageProgram 0x02
+#define NorCmdSectorErase 0x20
+#define NorCmdJedecId 0x9F
+
+/**
+ * @brief Write in progress bit of the status register
+ */
+#define NorStatusBusy 0x01
+
+#define FlashCs FlashCs_P1
+
+/**
+ * @brief Set if a chip answered the JEDEC ID
+ */
+extern uint8_t norPresent;
+
+inline void selectNor()
+{
+    FlashCs = 0;
+}
+
+inline void deselectNor()
+{
+    FlashCs = 1;
+}
+
+/**
+ * @brief Select the chip and send a command with a 24 bit address
+ *
+ * @param cmd command
+ * @param addr address
+ */
+void sendNorCommand(uint8_t cmd, uint32_t addr);
+
+/**
+ * @brief Check if the chip is programming or erasing, don't call it while a payload is streamed
+ *
+ * @return non-zero if busy
+ */
+uint8_t isNorBusy();
+
+/**
+ * @brief Allow the next program or erase
+ */
+void enableNorWrite();
+
+/**
+ * @brief Configure SPI and probe the chip, call it once at boot
+ *
+ * @return non-zero if a chip is present
+ */
+uint8_t initNorFlash();
+
+/**
+ * @brief Read bytes, blocking
+ *
+ * @param addr address to read from
+ * @param out buffer to hold the bytes
+ * @param len length to read
+ */
+void readNor(uint32_t addr, uint8_t* out, uint16_t len);
+
+/**
+ * @brief Read a byte, blocking
+ *
+ * @param addr address to read from
+ * @return byte read
+ */
+uint8_t readNorByte(uint32_t addr);
+
+/**
+ * @brief Start erasing the sector, poll isNorBusy() for the end
+ *
+ * @param addr address in the sector
+ */
+void eraseNorSector(uint32_t addr);
+
+/**
+ * @brief Deselect the chip so it starts programming, called in isr
+ */
+void onNorPayloadSent();
+
+/**
+ * @brief Start programming bytes within a page, poll spiBusy then isNorBusy() for the end
+ *
+ * @param addr address to program
+ * @param data bytes to program, must stay unchanged until spiBusy is cleared
+ * @param len length to program, at least 1 and not crossing a page
+ */
+void programNorPage(uint32_t addr, const uint8_t* data, uint16_t len);
+
+/**
+ * @brief Program bytes within a page and wait for the chip, for the LVD isr where the SPI isr can't run
+ *
+ * @param addr address to program
+ * @param data bytes to program
+ * @param len length to program, not crossing a page
+ */
+void writeNorPage(uint32_t addr, const uint8_t* data, uint16_t len);
\ No newline at end of file
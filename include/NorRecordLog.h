@@ -0,0 +1,153 @@
+/**
+ * @file NorRecordLog.h
+ * @brief Log of encoded records on a SPI NOR flash, the newest one wins
+ *
+ * Same interface as RecordLog.h. Records are appended into a RAM batch, and
+ * stepRecordLog() programs a whole batch with one page program while the
+ * next batch fills up, so the chip sees one program per NorBatchSize bytes
+ * under load instead of one per record.
+ *
+ * The log is a ring of NorLogSectorCount sectors. Entries never cross a
+ * sector, and the sector after the one in use is always erased, so the
+ * sector in use is the last one before an erased one.
+ *
+ * Entry layout: [encoded record] [commit mark]
+ * An entry without the commit mark was torn by power loss and is skipped.
+ */
+#pragma once
+#include "EEPROMCommitter.h"
+#include "NorFlash.h"
+#include "RecordCodec.h"
+#include "STC/Interrupt.h"
+#include "STC/SPI/SPI.h"
+#include "stdint.h"
+
+/**
+ * @brief First sector of the log
+ */
+#define NorLogAddr 0x000000UL
+
+/**
+ * @brief Sectors used by the log, must be a power of 2
+ */
+#define NorLogSectorCount 16
+#define NorLogSize (NorSectorSize * NorLogSectorCount)
+
+/**
+ * @brief Size of a batch, must divide NorPageSize
+ */
+#define NorBatchSize 64
+
+/**
+ * @brief Written after the record, an entry without it is skipped
+ */
+#define RecordLogMark 0x00
+
+/**
+ * @brief Max size of an encoded record in the log
+ */
+#define RecordLogMaxSize (CommitRecordSize - 1)
+
+/**
+ * @brief No record in the log
+ */
+#define RecordLogNone 0xFFFFFFFFUL
+
+/**
+ * @brief Get the first address of the sector after the one of addr
+ */
+#define NextNorLogSector(addr) (NorLogAddr + (((addr)-NorLogAddr + NorSectorSize) & (NorLogSize - 1) & ~(NorSectorSize - 1)))
+
+typedef struct NorBatch
+{
+    /**
+     * @brief Address of the first byte
+     */
+    uint32_t addr;
+    uint8_t  len;
+    uint8_t  data[NorBatchSize];
+} NorBatch_t;
+
+/**
+ * @brief One batch fills up while the other one is programmed
+ */
+extern __xdata NorBatch_t norBatches[2];
+
+/**
+ * @brief Index of the batch filling up
+ */
+extern uint8_t norFilling;
+/**
+ * @brief Offset of the next byte to program in the other batch
+ */
+extern uint8_t norProgOff;
+
+/**
+ * @brief Address of the first free byte
+ */
+extern uint32_t recordLogFree;
+/**
+ * @brief Address of the newest record, RecordLogNone if empty
+ */
+extern uint32_t recordLogNewest;
+/**
+ * @brief Sector to erase before the next program, RecordLogNone if none
+ */
+extern uint32_t norEraseAddr;
+
+/**
+ * @brief Entry read from the log
+ */
+extern __xdata uint8_t recordLogEntry[CommitRecordSize];
+
+/**
+ * @brief Read an encoded record, from a batch if it is not programmed yet
+ *
+ * @param addr address of the record
+ * @param out buffer to hold RecordLogMaxSize bytes
+ * @return size of the record, 0 if its header is broken or it runs off the sector
+ */
+uint8_t readRecordLogEntry(uint32_t addr, uint8_t* out);
+
+/**
+ * @brief Find the sector in use, the newest record and the free space, call it once at boot
+ */
+void initRecordLog();
+
+/**
+ * @brief Append an encoded record, it is programmed by stepRecordLog(), safe to call in isr
+ *
+ * @param record encoded record
+ * @param size size of the record
+ * @return non-zero if queued, zero if the batch is full and must be programmed first
+ */
+uint8_t appendRecordLog(const uint8_t* record, uint8_t size);
+
+/**
+ * @brief Start the next erase or page program if the chip is idle, call it from the main loop
+ */
+void stepRecordLog();
+
+/**
+ * @brief Read the newest record into recordLogEntry without decoding it, waits for the chip
+ *
+ * @return size of the encoded record, 0 if the log is empty
+ */
+uint8_t readNewestEntry();
+
+/**
+ * @brief Decode the newest record, waits for the chip
+ *
+ * @param out buffer to hold the record
+ * @param maxLen size of the buffer
+ * @return length of the record, 0 if the log is empty
+ */
+uint8_t readNewestRecord(uint8_t* out, uint8_t maxLen);
+
+/**
+ * @brief Program both batches synchronously, call it from the LVD isr
+ *
+ * Skipped if a command was in progress when the isr fired, as the chip
+ * can't take another one until it is done.
+ */
+void urgeRecordLog();
\ No newline at end of file
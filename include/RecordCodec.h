@@ -0,0 +1,112 @@
+/**
+ * @file RecordCodec.h
+ * @brief Compact encoding of records stored in EEPROM
+ *
+ * Encoded layout: [varint header] [body ...]
+ * header = body length << 1 | RecordDeltaRuns
+ *
+ * Without RecordDeltaRuns, the body is the raw record. With it, the body is
+ * the first byte followed by (delta, count) pairs, each adding delta to the
+ * previous byte count times. "abc...z" encodes into 4 bytes.
+ *
+ * Every record saved is a run, so only encodeRun() is linked in, and
+ * decodeRun() reads one back without decoding the body. Raw bodies are
+ * still decoded.
+ */
+#pragma once
+#include "stdint.h"
+
+/**
+ * @brief Set in the header if the body is encoded in delta runs
+ */
+#define RecordDeltaRuns 0x01
+
+/**
+ * @brief Size of a record encoded by encodeRun()
+ */
+#define RecordRunSize 4
+
+/**
+ * @brief Max bytes of a varint, 14 bits are enough for any header
+ */
+#define RecordVarintMaxLen 2
+
+/**
+ * @brief Read a varint of at most RecordVarintMaxLen bytes
+ *
+ * @param in buffer to read, only the bytes of the varint are read
+ * @param value value read
+ * @return bytes read, 0 if it is longer than RecordVarintMaxLen
+ */
+uint8_t getVarint(const uint8_t* in, uint16_t* value);
+
+/**
+ * @brief Encode a run of count + 1 bytes from first, each adding delta
+ *
+ * @param out buffer to hold RecordRunSize bytes
+ * @param first first byte of the run
+ * @param delta difference between two bytes
+ * @param count bytes following the first one
+ * @return size of the encoded record
+ */
+inline uint8_t encodeRun(uint8_t* out, uint8_t first, int8_t delta, uint8_t count)
+{
+    if (!count) {
+        out[0] = 1 << 1;
+        out[1] = first;
+        return 2;
+    }
+    out[0] = 3 << 1 | RecordDeltaRuns;
+    out[1] = first;
+    out[2] = delta;
+    out[3] = count;
+    return RecordRunSize;
+}
+
+/**
+ * @brief Read back a record encoded by encodeRun()
+ *
+ * @param in encoded record, at most RecordRunSize bytes are read
+ * @param first first byte of the run
+ * @param delta difference between two bytes, 0 if count is 0
+ * @param count bytes following the first one
+ * @return non-zero if the record is a single run
+ */
+inline uint8_t decodeRun(const uint8_t* in, uint8_t* first, int8_t* delta, uint8_t* count)
+{
+    if (in[0] == 1 << 1) {
+        *first = in[1];
+        *delta = 0;
+        *count = 0;
+        return 1;
+    }
+    if (in[0] != (3 << 1 | RecordDeltaRuns)) return 0;
+    *first = in[1];
+    *delta = in[2];
+    *count = in[3];
+    return 1;
+}
+
+/**
+ * @brief Get size of an encoded record from its header
+ *
+ * @param in encoded record, only the RecordVarintMaxLen bytes of the header are read
+ * @return size of the encoded record, 0 if the header is broken
+ */
+inline uint16_t encodedRecordSize(const uint8_t* in)
+{
+    uint16_t header;
+    uint8_t  len = getVarint(in, &header);
+    if (!len) return 0;
+    return len + (header >> 1);
+}
+
+/**
+ * @brief Decode a record
+ *
+ * @param in encoded record
+ * @param out buffer to hold the record
+ * @param maxLen size of the buffer, the rest is dropped
+ * @return length of the record, 0 if the header is broken
+ */
+uint8_t decodeRecord(const uint8_t* in, uint8_t* out, uint8_t maxLen);
@@ -0,0 +1,147 @@
+/**
+ * @file RecordHistory.h
+ * @brief Circular history of the last records in EEPROM
+ *
+ * The history is a ring of fixed size entries over HistorySectorCount
+ * sectors. Appending to the first entry of a sector erases it, dropping the
+ * oldest entries of the ring.
+ *
+ * Entries are committed by stepCommit() one byte per step, like the record
+ * log. A record saved while the previous entry is being committed replaces
+ * the one waiting, so a burst of requests only costs one entry. No entry is
+ * queued while a dump is being sent, so the dump is never torn by a commit.
+ *
+ * Entry layout: [len] [tick 4] [encoded record ...] [0xFF ...] [seq 2]
+ * tick and seq are little endian, seq is programmed last so a torn entry
+ * keeps seq 0xFFFF and is ignored.
+ */
+#pragma once
+#include "EEPROMCommitter.h"
+#include "STC/IAP/IAP.h"
+#include "STC/Interrupt.h"
+#include "STC/UART/TxQueue.h"
+#include "SoftTimer.h"
+#include "stdint.h"
+
+/**
+ * @brief First sector of the history
+ */
+#define HistoryAddr 0x0600
+
+/**
+ * @brief Sectors used by the history
+ */
+#define HistorySectorCount 4
+
+/**
+ * @brief Size of an entry in bytes, must divide IAPSectorSize and fit in CommitRecordSize
+ */
+#define HistoryEntrySize 16
+
+/**
+ * @brief Size of the header before the payload
+ */
+#define HistoryHeaderSize 5
+
+/**
+ * @brief Offset of the sequence number, at the end of the entry
+ */
+#define HistorySeqOffset (HistoryEntrySize - 2)
+
+#define HistoryEntriesPerSector (IAPSectorSize / HistoryEntrySize)
+#define HistoryEntryCount (HistoryEntriesPerSector * HistorySectorCount)
+#define HistoryMaxPayloadSize (HistorySeqOffset - HistoryHeaderSize)
+
+/**
+ * @brief Request to dump the history
+ */
+#define HistoryDumpRequest '?'
+
+/**
+ * @brief Starts a dump, followed by entry size, entry count and the entries
+ */
+#define HistoryDumpMagic 'H'
+#define HistoryDumpHeaderSize 3
+
+/**
+ * @brief Entry to append next
+ */
+extern uint8_t historyHead;
+/**
+ * @brief Count of valid entries in the ring
+ */
+extern uint8_t historyCount;
+/**
+ * @brief Sequence number of the next entry
+ */
+extern uint16_t historySeq;
+
+/**
+ * @brief Entry waiting to be queued, its seq is set when queued
+ */
+extern __xdata uint8_t historyEntry[HistoryEntrySize];
+/**
+ * @brief Set while historyEntry waits to be queued
+ */
+extern uint8_t historyStaged;
+/**
+ * @brief Set while an entry is being committed
+ */
+extern uint8_t historyBusy;
+/**
+ * @brief Set while the dump is being sent
+ */
+extern uint8_t historyDumping;
+/**
+ * @brief Last TX descriptor of the dump
+ */
+extern uint8_t historyDumpDesc;
+
+/**
+ * @brief Get address of an entry
+ */
+#define HistoryEntryAddr(entry) (HistoryAddr + (uint16_t)(entry)*HistoryEntrySize)
+
+/**
+ * @brief Read sequence number of an entry
+ *
+ * @param entry index of the entry
+ * @return sequence number, 0xFFFF if the entry is empty
+ */
+uint16_t readHistorySeq(uint8_t entry);
+
+/**
+ * @brief Find the newest entry, call it once at boot
+ */
+void initHistory();
+
+/**
+ * @brief Stage a record for the history, it is queued by stepHistory(), don't call it in isr
+ *
+ * Replaces the record staged before if it is not queued yet.
+ *
+ * @param data encoded record
+ * @param len size of the record, longer records are truncated to HistoryMaxPayloadSize
+ */
+void appendHistory(const uint8_t* data, uint8_t len);
+
+/**
+ * @brief Called when an entry is committed, in the main loop or the LVD isr
+ */
+void onHistoryCommitted(uint16_t addr);
+
+/**
+ * @brief Queue the staged record once the last entry is committed and no dump is sent, call it from the main loop
+ */
+void stepHistory();
+
+/**
+ * @brief Stream every entry from the oldest to the newest through the TX queue
+ *
+ * Takes at most 3 descriptors, entries are sent straight from EEPROM. The
+ * entry being committed is left out, and no other one is queued until the
+ * dump is sent. Nothing is queued unless the whole dump fits.
+ *
+ * @return non-zero if queued
+ */
+uint8_t dumpHistory();
\ No newline at end of file
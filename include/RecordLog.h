@@ -0,0 +1,116 @@
+/**
+ * @file RecordLog.h
+ * @brief Log of encoded records in one EEPROM sector, the newest one wins
+ *
+ * Records are appended one after another and the sector is only erased when
+ * the next record doesn't fit, so a sector holds many records per erase.
+ *
+ * Entry layout: [encoded record] [commit mark]
+ * An entry without the commit mark was torn by power loss and is skipped.
+ */
+#pragma once
+#include "EEPROMCommitter.h"
+#include "RecordCodec.h"
+#include "STC/IAP/IAP.h"
+#include "stdint.h"
+
+/**
+ * @brief Sector of the log
+ */
+#define RecordLogAddr 0x0000
+
+/**
+ * @brief Written after the record, an entry without it is skipped
+ */
+#define RecordLogMark 0x00
+
+/**
+ * @brief Max size of an encoded record in the log
+ */
+#define RecordLogMaxSize (CommitRecordSize - 1)
+
+/**
+ * @brief No record in the log
+ */
+#define RecordLogNone 0xFFFF
+
+/**
+ * @brief Offset of the first free byte
+ */
+extern uint16_t recordLogFree;
+/**
+ * @brief Offset of the newest record, RecordLogNone if empty
+ */
+extern uint16_t recordLogNewest;
+/**
+ * @brief Set while an append is being committed
+ */
+extern uint8_t recordLogBusy;
+
+/**
+ * @brief Entry read from the log
+ */
+extern __xdata uint8_t recordLogEntry[CommitRecordSize];
+/**
+ * @brief Entry to append, appendRecordLog() could be called in isr
+ */
+extern __xdata uint8_t recordLogAppend[CommitRecordSize];
+
+/**
+ * @brief Read an encoded record from the log
+ *
+ * @param off offset of the record
+ * @param out buffer to hold RecordLogMaxSize bytes
+ * @return size of the record, 0 if its header is broken or it runs off the sector
+ */
+uint8_t readRecordLogEntry(uint16_t off, uint8_t* out);
+
+/**
+ * @brief Find the newest record and the free space, call it once at boot
+ */
+void initRecordLog();
+
+/**
+ * @brief Called when an append is committed
+ */
+void onRecordLogCommitted(uint16_t addr);
+
+/**
+ * @brief Append an encoded record, it is committed by stepCommit(), safe to call in isr
+ *
+ * @param record encoded record
+ * @param size size of the record
+ * @return non-zero if queued, zero if the previous one is not committed yet
+ */
+uint8_t appendRecordLog(const uint8_t* record, uint8_t size);
+
+/**
+ * @brief Read the newest record into recordLogEntry without decoding it
+ *
+ * @return size of the encoded record, 0 if the log is empty
+ */
+uint8_t readNewestEntry();
+
+/**
+ * @brief Decode the newest record
+ *
+ * @param out buffer to hold the record
+ * @param maxLen size of the buffer
+ * @return length of the record, 0 if the log is empty
+ */
+uint8_t readNewestRecord(uint8_t* out, uint8_t maxLen);
+
+/**
+ * @brief Nothing to do, stepCommit() commits the appends
+ */
+inline void stepRecordLog()
+{
+}
+
+/**
+ * @brief Commit the pending append synchronously, call it from the LVD isr
+ */
+inline void urgeRecordLog()
+{
+    urgeCommit();
+}
\ No newline at end of file
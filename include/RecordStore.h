@@ -0,0 +1,21 @@
+/**
+ * @file RecordStore.h
+ * @brief Select where saved records are logged
+ *
+ * Both logs provide initRecordLog(), appendRecordLog(), readNewestEntry(),
+ * readNewestRecord(), stepRecordLog() and urgeRecordLog().
+ */
+#pragma once
+
+/**
+ * @brief Set to 1 to log records on the SPI NOR flash instead of the IAP EEPROM
+ */
+#ifndef RecordStoreOnNor
+#define RecordStoreOnNor 0
+#endif
+
+#if RecordStoreOnNor
+#include "NorRecordLog.h"
+#else
+#include "RecordLog.h"
+#endif
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+#include "STC/Interrupt.h"
+#include "STC/STCBase.h"
+#include "stdint.h"
+
+/**
+ * @brief Conversion time of the ADC, value of SPEED1/SPEED0
+ */
+typedef enum ADCSpeed {
+    /**
+     * @brief 540 SysClock per conversion
+     */
+    ADCSpeed_540,
+    ADCSpeed_360,
+    ADCSpeed_180,
+    ADCSpeed_90
+} ADCSpeed_t;
+
+/**
+ * @brief How many SysClock a conversion takes at speed
+ */
+#define ADCClocksPerConversion(speed) \
+    ((speed) == ADCSpeed_540 ? 540 : (speed) == ADCSpeed_360 ? 360 : (speed) == ADCSpeed_180 ? 180 : 90)
+
+/**
+ * @brief Conversions per second at speed
+ */
+#define ADCConversionsPerSecond(speed) (SysClock / ADCClocksPerConversion(speed))
+
+/**
+ * @brief Input of the ADC
+ * Channel n -> ADCn/P1.n
+ */
+typedef enum ADCChannel {
+    ADCChannel0,
+    ADCChannel1,
+    ADCChannel2,
+    ADCChannel3,
+    ADCChannel4,
+    ADCChannel5,
+    ADCChannel6,
+    ADCChannel7
+} ADCChannel_t;
+
+/**
+ * @brief Max value of a 10 bit result
+ */
+#define ADCMaxValue 0x3FF
+
+typedef struct ADCCfg
+{
+    ADCSpeed_t  speed;
+    /**
+     * @brief Bit n set to use P1.n as analog input
+     */
+    uint8_t     inputs;
+    Interrupt_t it;
+} ADCCfg_t, *pADCCfg;
+
+/**
+ * @brief Power on and configure the ADC
+ *
+ * Wait about 1 ms before the first conversion so the supply settles
+ *
+ * @param cfg configuration
+ */
+void configureADC(pADCCfg cfg);
+
+/**
+ * @brief Power off the ADC
+ */
+inline void powerOffADC()
+{
+    ADC_CONTR = 0x00;
+}
+
+/**
+ * @brief Start a conversion, clearing ADC_FLAG of the last one
+ *
+ * ADC_CONTR is assigned as a whole, read-modify-write of ADC_START is unreliable
+ *
+ * @param channel input to convert
+ */
+inline void startADC(ADCChannel_t channel)
+{
+    ADC_CONTR = (ADC_CONTR & 0xE0) | 0x08 | channel;
+}
+
+/**
+ * @brief Check if ADC_FLAG is set
+ *
+ * @return non-zero if a conversion is done
+ */
+inline int checkADCFlag()
+{
+    return ADC_CONTR & 0x10;
+}
+
+/**
+ * @brief Clear ADC_FLAG
+ */
+inline void clearADCFlag()
+{
+    ADC_CONTR &= 0xE7;
+}
+
+/**
+ * @brief Read the result of the last conversion
+ *
+ * @return 10 bit result
+ */
+inline uint16_t readADC()
+{
+    return (uint16_t)ADC_RES << 2 | (ADC_RESL & 0x03);
+}
\ No newline at end of file
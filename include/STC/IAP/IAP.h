@@ -1,5 +1,7 @@
 #pragma once
+#include "STC/Interrupt.h"
 #include "STC/STCBase.h"
+#include "STC/Trace.h"
 
 /**
  * @brief Write this key before writing any ISP/IAP CMD
@@ -23,6 +25,21 @@
  */
 #define IAP_WAIT_TIME IAP_WAIT_TIME_12MHz
 
+/**
+ * @brief Size of an EEPROM sector, the unit of erase
+ */
+#define IAPSectorSize 512
+
+/**
+ * @brief Worst-case time of a sector erase in microsecond, CPU stalls meanwhile
+ */
+#define IAPEraseTimeUs 21000
+
+/**
+ * @brief Worst-case time of a byte program in microsecond, CPU stalls meanwhile
+ */
+#define IAPProgramTimeUs 55
+
 /**
  * @brief Bootstrap area
  */
@@ -85,9 +102,12 @@ inline void clearCMDFail()
  */
 inline void triggerIAPOp()
 {
-    IAP_TRIG = IAP_KEY;
-    IAP_TRIG = IAP_KEY >> 8;
+    // An isr triggering IAP between the two keys would break the sequence
+    CriticalState_t state = enterCritical();
+    IAP_TRIG              = IAP_KEY;
+    IAP_TRIG              = IAP_KEY >> 8;
     NOP();
+    exitCritical(state);
 }
 
 /**
@@ -106,7 +126,10 @@ inline void doIAPOp(IAPCMD_t cmd)
         case Write: IAP_CMD = 0x02; break;
         case Erase: IAP_CMD = 0x03; break;
     }
+    // Reads are too frequent to trace
+    if (cmd != Read) TRACE(TraceIAPEnter);
     triggerIAPOp();
+    if (cmd != Read) TRACE(TraceIAPExit);
     disableIAP();
 }
 
@@ -161,4 +184,39 @@ inline uint8_t readFromIAP()
 {
     doIAPOp(Read);
     return IAP_DATA;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Read data from addr
+ *
+ * @param addr address to read
+ * @return uint8_t data of addr
+ */
+inline uint8_t readIAPAt(uint16_t addr)
+{
+    writeIAPAddr(addr);
+    return readFromIAP();
+}
+
+/**
+ * @brief Write data to addr, the byte must be erased before
+ *
+ * @param addr address to write
+ * @param data data to write
+ */
+inline void writeIAPAt(uint16_t addr, uint8_t data)
+{
+    writeIAPAddr(addr);
+    writeToIAP(data);
+}
+
+/**
+ * @brief Read data from addr and keep the IAP registers intact
+ *
+ * Safe to call in isr while the main loop is in the middle of an IAP operation,
+ * the read is done with interrupts disabled so no other isr moves the address
+ *
+ * @param addr address to read
+ * @return uint8_t data of addr
+ */
+uint8_t peekIAP(uint16_t addr);
\ No newline at end of file
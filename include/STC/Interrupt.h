@@ -1,5 +1,6 @@
 #pragma once
 #include "STC/STCBase.h"
+#include "stdint.h"
 
 /**
  * @brief Enable interrupt globally
@@ -16,4 +17,63 @@ inline void disableGlobalInterrupt()
     EA = 0;
 }
 
-typedef enum Interrupt { DisableIT, EnableIT } Interrupt_t;
\ No newline at end of file
+typedef enum Interrupt { DisableIT, EnableIT } Interrupt_t;
+
+/**
+ * @brief EA saved by enterCritical()
+ */
+typedef uint8_t CriticalState_t;
+
+/**
+ * @brief Disable interrupt globally and keep EA to restore, nests in isr or another critical section
+ *
+ * @return EA before
+ */
+inline CriticalState_t enterCritical()
+{
+    CriticalState_t state = EA;
+    EA                    = 0;
+    return state;
+}
+
+/**
+ * @brief Restore EA saved by enterCritical()
+ *
+ * @param state value returned by enterCritical()
+ */
+inline void exitCritical(CriticalState_t state)
+{
+    EA = state;
+}
+
+/**
+ * @brief Enable bits of interrupt sources in IE
+ */
+#define InterruptTimer0 0x02
+#define InterruptTimer1 0x08
+#define InterruptUART1 0x10
+#define InterruptADC 0x20
+#define InterruptLVD 0x40
+
+/**
+ * @brief Disable only some interrupt sources, others keep being serviced
+ *
+ * @param sources Interrupt* bits to disable
+ * @return bits that were enabled, to pass to unmaskInterrupt()
+ */
+inline uint8_t maskInterrupt(uint8_t sources)
+{
+    uint8_t enabled = IE & sources;
+    IE &= ~sources;
+    return enabled;
+}
+
+/**
+ * @brief Enable again the sources disabled by maskInterrupt()
+ *
+ * @param enabled value returned by maskInterrupt()
+ */
+inline void unmaskInterrupt(uint8_t enabled)
+{
+    IE |= enabled;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+#include "STC/STCBase.h"
+
+/**
+ * @brief Check if LVDF is set
+ *
+ * LVDF is set by hardware when Vcc drops below the low voltage threshold
+ *
+ * @return LVDF of PCON
+ */
+inline int checkLVDF()
+{
+    return PCON & 0x20;
+}
+
+/**
+ * @brief Clear LVDF bit
+ */
+inline void clearLVDF()
+{
+    PCON &= 0xDF;
+}
+
+/**
+ * @brief Enable low voltage detect interrupt with the highest priority
+ *
+ * Clear LVDF before enabling, it is set on power up
+ */
+inline void enableLVDInterrupt()
+{
+    PLVD = 1;
+    IPH |= 0x40;
+    ELVD = 1;
+}
+
+/**
+ * @brief Disable low voltage detect interrupt
+ */
+inline void disableLVDInterrupt()
+{
+    ELVD = 0;
+}
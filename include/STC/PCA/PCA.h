@@ -0,0 +1,198 @@
+#pragma once
+#include "STC/Interrupt.h"
+#include "STC/STCBase.h"
+#include "stdint.h"
+
+/**
+ * @brief Clock source of the PCA counter
+ */
+typedef enum PCAClockSource {
+    PCAClock_DIV_12,
+    PCAClock_DIV_2,
+    /**
+     * @brief Count overflows of Timer0
+     */
+    PCAClock_Timer0,
+    /**
+     * @brief Count pulses on ECI/P1.2
+     */
+    PCAClock_External,
+    PCAClock_DIV_1,
+    PCAClock_DIV_4,
+    PCAClock_DIV_6,
+    PCAClock_DIV_8
+} PCAClockSource_t;
+
+/**
+ * @brief Clock source of the PCA counter in use
+ */
+#define PCAClockSource PCAClock_DIV_12
+
+/**
+ * @brief Frequency of the PCA counter
+ */
+#define PCAClock (SysClock / 12)
+
+/**
+ * @brief How many PCA ticks it takes to transfer bits at baud
+ */
+#define BitsToPCATicks(bits, baud) ((uint16_t)(PCAClock / (baud) * (bits)))
+
+/**
+ * @brief Module of the PCA
+ * Module0 -> CEX0/P1.3
+ * Module1 -> CEX1/P1.4
+ */
+typedef enum PCAModule { PCAModule0, PCAModule1 } PCAModule_t;
+
+typedef enum PCAMode {
+    PCADisabled,
+    /**
+     * @brief Set CCFx when the counter matches CCAPx
+     */
+    PCASoftTimer,
+    /**
+     * @brief Toggle CEXx when the counter matches CCAPx
+     */
+    PCAHighSpeedOutput,
+    /**
+     * @brief 8 bit PWM on CEXx, duty is set by CCAPxH
+     */
+    PCAPWM,
+    /**
+     * @brief Capture the counter into CCAPx on edges of CEXx
+     */
+    PCACaptureRising,
+    PCACaptureFalling,
+    PCACaptureBoth
+} PCAMode_t;
+
+typedef struct PCACfg
+{
+    PCAClockSource_t source;
+    /**
+     * @brief Keep counting in idle mode
+     */
+    uint8_t          runInIdle;
+    /**
+     * @brief Interrupt on counter overflow
+     */
+    Interrupt_t      overflowIT;
+} PCACfg_t, *pPCACfg;
+
+/**
+ * @brief Configure the PCA counter, it is stopped and cleared
+ *
+ * @param cfg configuration
+ */
+void configurePCA(pPCACfg cfg);
+
+/**
+ * @brief Configure a module of the PCA
+ *
+ * @param module which module to config
+ * @param mode mode of the module
+ * @param it interrupt on CCFx
+ */
+void configurePCAModule(PCAModule_t module, PCAMode_t mode, Interrupt_t it);
+
+inline void startPCA()
+{
+    CR = 1;
+}
+
+inline void stopPCA()
+{
+    CR = 0;
+}
+
+/**
+ * @brief Read the PCA counter while it is counting
+ *
+ * @return value of the counter
+ */
+inline uint16_t readPCACounter()
+{
+    uint8_t high, low;
+    do {
+        high = CH;
+        low  = CL;
+    } while (high != CH);
+    return (uint16_t)high << 8 | low;
+}
+
+/**
+ * @brief Set the compare value of a module and arm it
+ *
+ * Writing CCAPxL clears ECOMx, writing CCAPxH sets it again
+ *
+ * @param module which module to set
+ * @param value compare value
+ */
+inline void setPCACompare(PCAModule_t module, uint16_t value)
+{
+    switch (module) {
+        case PCAModule0:
+            CCAP0L = value;
+            CCAP0H = value >> 8;
+            break;
+        case PCAModule1:
+            CCAP1L = value;
+            CCAP1H = value >> 8;
+            break;
+    }
+}
+
+/**
+ * @brief Stop a module from matching until setPCACompare() arms it again
+ *
+ * @param module which module to disarm
+ */
+inline void disarmPCAModule(PCAModule_t module)
+{
+    switch (module) {
+        case PCAModule0: CCAPM0 &= 0xBF; break;
+        case PCAModule1: CCAPM1 &= 0xBF; break;
+    }
+}
+
+/**
+ * @brief Read the captured value of a module
+ *
+ * @param module which module to read
+ * @return captured value
+ */
+inline uint16_t readPCACapture(PCAModule_t module)
+{
+    switch (module) {
+        case PCAModule0: return (uint16_t)CCAP0H << 8 | CCAP0L;
+        case PCAModule1: return (uint16_t)CCAP1H << 8 | CCAP1L;
+    }
+}
+
+/**
+ * @brief Check if CCFx is set
+ *
+ * @param module which module to check
+ * @return CCFx of specific module
+ */
+inline int checkCCF(PCAModule_t module)
+{
+    switch (module) {
+        case PCAModule0: return CCF0;
+        case PCAModule1: return CCF1;
+    }
+}
+
+/**
+ * @brief Clear CCFx bit of specific module
+ *
+ * @param module which module to clear
+ */
+inline void clearCCF(PCAModule_t module)
+{
+    switch (module) {
+        case PCAModule0: CCF0 = 0; break;
+        case PCAModule1: CCF1 = 0; break;
+    }
+}
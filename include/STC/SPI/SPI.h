@@ -0,0 +1,97 @@
+#pragma once
+#include "STC/Interrupt.h"
+#include "STC/STCBase.h"
+#include "stdint.h"
+
+/**
+ * @brief Clock of SPICLK in master mode
+ */
+typedef enum SPIClock { SPIClock_DIV_4, SPIClock_DIV_16, SPIClock_DIV_64, SPIClock_DIV_128 } SPIClock_t;
+
+/**
+ * @brief Clock polarity and phase
+ */
+typedef enum SPIMode { SPIMode0, SPIMode1, SPIMode2, SPIMode3 } SPIMode_t;
+
+typedef struct SPICfg
+{
+    SPIClock_t clock;
+    SPIMode_t  mode;
+    /**
+     * @brief Send the LSB first
+     */
+    uint8_t    lsbFirst;
+} SPICfg_t, *pSPICfg;
+
+/**
+ * @brief How many SysClock it takes to transfer a byte
+ */
+#define SPIClocksPerByte(clock) (8 * ((clock) == SPIClock_DIV_4 ? 4 : (clock) == SPIClock_DIV_16 ? 16 : (clock) == SPIClock_DIV_64 ? 64 : 128))
+
+/**
+ * @brief Called in isr when a transfer is done
+ */
+typedef void (*SPICallback_t)();
+
+/**
+ * @brief Bytes to send, null to send 0xFF
+ */
+extern const uint8_t* spiTx;
+/**
+ * @brief Buffer for received bytes, null to drop them
+ */
+extern uint8_t*      spiRx;
+extern uint16_t      spiLen;
+extern SPICallback_t spiOnDone;
+/**
+ * @brief Set while a transfer is in progress
+ */
+extern uint8_t spiBusy;
+
+/**
+ * @brief Configure SPI as master, SS is ignored and chip selects are driven as GPIO
+ *
+ * @param cfg configuration
+ */
+void configureSPI(pSPICfg cfg);
+
+/**
+ * @brief Check if SPIF is set
+ *
+ * @return non-zero if a byte is transferred
+ */
+inline int checkSPIF()
+{
+    return SPSTAT & 0x80;
+}
+
+/**
+ * @brief Clear SPIF and WCOL
+ */
+inline void clearSPIF()
+{
+    SPSTAT = 0xC0;
+}
+
+/**
+ * @brief Transfer a byte and wait, don't call it while a transfer is in progress
+ *
+ * @param data byte to send
+ * @return byte received
+ */
+uint8_t transferSPI(uint8_t data);
+
+/**
+ * @brief Start transferring bytes in the background
+ *
+ * @param tx bytes to send, null to send 0xFF
+ * @param rx buffer for received bytes, null to drop them
+ * @param len length to transfer, at least 1
+ * @param onDone called in isr when done, could be null
+ */
+void startSPITransfer(const uint8_t* tx, uint8_t* rx, uint16_t len, SPICallback_t onDone);
+
+/**
+ * @brief Move to the next byte, call it in isr on SPIF
+ */
+void onSPIDone();
\ No newline at end of file
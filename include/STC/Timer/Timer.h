@@ -63,7 +63,23 @@ typedef struct TimerCfg
     Interrupt_t          it;
 } TimerCfg_t, *pTimerCfg;
 
-void configureTimer(Timer_t timer, pTimerCfg cfg)
+/**
+ * @brief Register images of a timer computed at compile time from TimerCfg_t field values
+ *
+ * Images of several timers are or-ed together and written at once, e.g.
+ * TMOD = TimerTMODImage(Timer0, ...) | TimerTMODImage(Timer1, ...);
+ * instead of calling configureTimer() for each of them.
+ */
+#define TimerTMODImage(timer, source, mode, gate)                                                    \
+    ((((source) == External ? 0x04 : 0x00) | (mode) | ((gate) == Enable_WHEN_INT_HIGH ? 0x08 : 0x00)) \
+     << ((timer) == Timer1 ? 4 : 0))
+#define TimerAUXRImage(timer, source) ((source) == SysClock_DIV_1 ? ((timer) == Timer1 ? 0x40 : 0x80) : 0x00)
+#define TimerIEImage(timer, it) ((it) == EnableIT ? ((timer) == Timer1 ? 0x08 : 0x02) : 0x00)
+
+/**
+ * @brief Configure a timer at runtime, prefer the images where the configuration is constant
+ */
+inline void configureTimer(Timer_t timer, pTimerCfg cfg)
 {
     switch (timer) {
         case Timer0:
@@ -117,7 +133,7 @@ void configureTimer(Timer_t timer, pTimerCfg cfg)
 
 #define ToReloadValue(x) (0xFFFF - x)
 #define ToReloadValueDIV12(x) (0xFFFF - x / 12)
-#define ToReloadValueAutoReload(x) (ToReloadValue(x) & 0x00FF | ToReloadValue(x) << 8)
+#define ToReloadValueAutoReload(x) ((ToReloadValue(x) & 0x00FF) | ToReloadValue(x) << 8)
 #define ToReloadValueAutoReloadDIV12(x) (ToReloadValueDIV12(x) & 0x00FF | ToReloadValueDIV12(x) << 8)
 
 inline void reloadTimer(Timer_t timer, uint16_t reloadValue)
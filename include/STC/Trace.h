@@ -0,0 +1,103 @@
+/**
+ * @file Trace.h
+ * @brief Ring of timestamped events, e.g. isr entries and exits, compiled out unless TraceEnabled
+ *
+ * TRACE(event) records the event and the PCA counter, in about 40 clocks.
+ * A tick is 12 clocks and the counter wraps every 71 ms, the Timer0 events
+ * keep the gaps shorter than that. The ring keeps the last TraceRingSize
+ * events, see TraceDump.h to send them. Without TraceEnabled the ring isn't
+ * defined and TraceDump.h must not be included.
+ */
+#pragma once
+#include "STC/Interrupt.h"
+#include "STC/PCA/PCA.h"
+#include "stdint.h"
+
+/**
+ * @brief Set to 1 to record the TRACE() events
+ */
+#ifndef TraceEnabled
+#define TraceEnabled 0
+#endif
+
+/**
+ * @brief Events kept, must be a power of 2 and at most 128
+ */
+#define TraceRingSize 64
+
+/**
+ * @brief Events, an exit is its entry + 1, keep tools/trace_decode.py in sync
+ */
+typedef enum TraceEvent {
+    TraceTimer0Enter,
+    TraceTimer0Exit,
+    TraceUART1Enter,
+    TraceUART1Exit,
+    TraceADCEnter,
+    TraceADCExit,
+    TracePCAEnter,
+    TracePCAExit,
+    TraceSPIEnter,
+    TraceSPIExit,
+    TraceLVDEnter,
+    TraceLVDExit,
+    /**
+     * @brief From triggering an IAP write or erase to its end, the CPU stalls meanwhile
+     */
+    TraceIAPEnter,
+    TraceIAPExit,
+    /**
+     * @brief Free for ad hoc marks
+     */
+    TraceMark
+} TraceEvent_t;
+
+typedef struct TraceRecord
+{
+    uint8_t  event;
+    /**
+     * @brief PCA counter
+     */
+    uint16_t time;
+} TraceRecord_t;
+
+#if TraceEnabled
+#define TRACE(event) traceEvent(event)
+
+extern __xdata TraceRecord_t traceRing[TraceRingSize];
+
+/**
+ * @brief Index of the next record
+ */
+extern uint8_t traceHead;
+/**
+ * @brief Set once the ring is full, the oldest record is then at traceHead
+ */
+extern uint8_t traceWrapped;
+/**
+ * @brief Set while the ring is being sent, events are dropped meanwhile
+ */
+extern uint8_t traceFrozen;
+
+/**
+ * @brief Record an event, use TRACE() instead
+ *
+ * @param event event to record
+ */
+inline void traceEvent(TraceEvent_t event)
+{
+    __xdata TraceRecord_t* record;
+    CriticalState_t        state;
+
+    if (traceFrozen) return;
+    state         = enterCritical();
+    record        = &traceRing[traceHead];
+    record->event = event;
+    record->time  = readPCACounter();
+    traceHead     = (traceHead + 1) & (TraceRingSize - 1);
+    if (!traceHead) traceWrapped = 1;
+    exitCritical(state);
+}
+#else
+#define TRACE(event)
+#endif
\ No newline at end of file
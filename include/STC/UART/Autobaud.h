@@ -0,0 +1,204 @@
+/**
+ * @file Autobaud.h
+ * @brief Detect the baud rate of UART1 from sync bytes sent by the host
+ *
+ * The host sends AutobaudSync (0x55) until it reads AutobaudAck. RXD can't be
+ * captured by the PCA, so it is polled while Timer1 counts SysClock: the
+ * falling edges of 0x55 are 2 bit-times apart, and the first and the fifth
+ * one are 8 bit-times apart. The closest rate of autobaudRates is loaded into
+ * BRT, and locked if the next byte received at that rate is a sync byte too.
+ * The sync bytes the host sends until it reads AutobaudAck are dropped.
+ *
+ * Timer1 is used while detecting. Timer0 and ADC interrupts are masked while
+ * a byte is measured, so soft timers run slow until the rate is locked. LVD
+ * is left enabled and only spoils the measurement it interrupts.
+ *
+ * With SimBaudTimer1, Timer1 counts SysClock/12 as simulators don't model
+ * AUXR, and the rate is loaded into Timer1 instead of BRT. Only the rates
+ * dividing SysClock/384 then lock, from 1200 to 14400 and 28800.
+ */
+#pragma once
+#include "BoardBase.h"
+#include "STC/Interrupt.h"
+#include "STC/PCA/PCA.h"
+#include "STC/STCBase.h"
+#include "STC/Timer/Timer.h"
+#include "STC/UART/UART.h"
+#include "stdint.h"
+
+/**
+ * @brief Sent by the host until it reads AutobaudAck
+ */
+#define AutobaudSync 0x55
+
+/**
+ * @brief Sent once the rate is locked
+ */
+#define AutobaudAck '\n'
+
+/**
+ * @brief Give up and keep the fallback rate after this long
+ */
+#define AutobaudTimeoutMs 2000
+
+/**
+ * @brief SysClock per count of Timer1 while detecting
+ */
+#define AutobaudTimerClocks (SimBaudTimer1 ? 12 : 1)
+
+/**
+ * @brief Timer1 overflows to wait for a sync byte before letting the masked isr run, ~6 ms each
+ */
+#define AutobaudWaitOverflows 2
+#define AutobaudAttempts (AutobaudTimeoutMs * SysClockOfOneMs / (65536UL * AutobaudTimerClocks) / AutobaudWaitOverflows)
+
+/**
+ * @brief Wait for the byte confirming a rate, longer than the host waits for AutobaudAck
+ */
+#define AutobaudConfirmMs 48
+#define AutobaudConfirmTicks ((uint16_t)(PCAClock / 1000 * AutobaudConfirmMs))
+
+/**
+ * @brief Silence ending the sync bytes after the lock, longer than the host takes to stop once it reads AutobaudAck
+ */
+#define AutobaudSettleMs 50
+#define AutobaudSettleTicks ((uint16_t)(PCAClock / 1000 * AutobaudSettleMs))
+
+/**
+ * @brief Largest error of a measured bit-time, as a power of 2 of the bit-time
+ *
+ * Polling takes about 20 clocks per edge, 3% of the 8 bit-times measured at
+ * 115200, and the closest standard rates are 33% apart.
+ */
+#define AutobaudToleranceBits 3
+
+#define AutobaudInterrupts (InterruptTimer0 | InterruptADC)
+
+/**
+ * @brief RXD of UART1
+ */
+#define AutobaudRxd P30
+
+/**
+ * @brief BRT divider of a baud rate, with BRT counting SysClock and SMOD cleared
+ */
+#define AutobaudDivider(baud) (SysClock / 32 / (baud))
+
+/**
+ * @brief Reload value of BRT for a baud rate, BRT counts SysClock/12 if the divider doesn't fit in 8 bits
+ *
+ * SMOD is never needed, at 11.0592 MHz every standard rate divides SysClock/32.
+ * Timer1 standing in for BRT always counts SysClock/12, the rates it can't
+ * make fail to confirm.
+ */
+#if SimBaudTimer1
+#define AutobaudReload(baud) ((uint8_t)(256 - AutobaudDivider(baud) / 12))
+#define AutobaudRate(baud) {(baud), SysClock / (baud), AutobaudReload(baud), 0}
+#else
+#define AutobaudReload(baud) (AutobaudDivider(baud) <= 256 ? 256 - AutobaudDivider(baud) : 256 - AutobaudDivider(baud) / 12)
+#define AutobaudRate(baud) {(baud), SysClock / (baud), AutobaudReload(baud), AutobaudDivider(baud) <= 256}
+#endif
+
+typedef struct AutobaudRate
+{
+    uint32_t baud;
+    /**
+     * @brief SysClock per bit
+     */
+    uint16_t clocksPerBit;
+    /**
+     * @brief Reload value of BRT
+     */
+    uint8_t  reload;
+    /**
+     * @brief BRT counts SysClock instead of SysClock/12
+     */
+    uint8_t  brt1T;
+} AutobaudRate_t;
+
+/**
+ * @brief Standard rates from 1200 to 115200
+ */
+#define AutobaudRateCount 10
+extern __code AutobaudRate_t autobaudRates[AutobaudRateCount];
+
+/**
+ * @brief Timer1 overflows since the last reset of the count
+ */
+extern uint8_t autobaudOverflows;
+
+/**
+ * @brief Wait for RXD to reach a level, counting Timer1 overflows
+ *
+ * @param level level to wait for
+ * @param limit overflow count to give up at
+ * @return non-zero if the level is reached
+ */
+uint8_t waitAutobaudRxd(uint8_t level, uint8_t limit);
+
+/**
+ * @brief Restart Timer1 from 0 counting SysClock, or SysClock/12 with SimBaudTimer1
+ */
+inline void restartAutobaudTimer()
+{
+    TR1 = 0;
+#if SimBaudTimer1
+    TMOD = (TMOD & 0x0F) | TimerTMODImage(Timer1, SysClock_DIV_12, Counter_BIT_16, Ignore);
+#else
+    TMOD = (TMOD & 0x0F) | TimerTMODImage(Timer1, SysClock_DIV_1, Counter_BIT_16, Ignore);
+    AUXR |= TimerAUXRImage(Timer1, SysClock_DIV_1);
+#endif
+    TL1               = 0;
+    TH1               = 0;
+    TF1               = 0;
+    autobaudOverflows = 0;
+    TR1               = 1;
+}
+
+/**
+ * @brief Measure a sync byte, call it with AutobaudInterrupts masked
+ *
+ * @return SysClock per bit, 0 if no sync byte came
+ */
+uint16_t measureAutobaudBit();
+
+/**
+ * @brief Find the rate closest to a measured bit-time
+ *
+ * @param clocksPerBit SysClock per bit
+ * @return rate, null if none is within tolerance
+ */
+__code AutobaudRate_t* findAutobaudRate(uint16_t clocksPerBit);
+
+/**
+ * @brief Load a rate into BRT, or into Timer1 with SimBaudTimer1
+ *
+ * @param reload reload value of BRT
+ * @param brt1T non-zero if BRT counts SysClock
+ */
+void loadAutobaudRate(uint8_t reload, uint8_t brt1T);
+
+/**
+ * @brief Receive the next byte at the loaded rate and ack it if it is a sync byte
+ *
+ * RX is left enabled once locked.
+ *
+ * @return non-zero if locked
+ */
+uint8_t confirmAutobaud();
+
+/**
+ * @brief Drop the sync bytes still coming after the lock, until AutobaudSettleMs without one
+ *
+ * Call it after confirmAutobaud() locked. A byte other than AutobaudSync is left in SBUF with RI set, for the UART1
+ * isr once enabled.
+ */
+void settleAutobaud();
+
+/**
+ * @brief Detect the rate of the host, call it before enabling RX of UART1 and after starting the PCA counter
+ *
+ * @param fallback baud rate the baud generator is loaded for, kept if no host locks
+ * @return baud rate in use
+ */
+uint32_t detectBaud(uint32_t fallback);
\ No newline at end of file
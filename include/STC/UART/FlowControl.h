@@ -0,0 +1,131 @@
+/**
+ * @file FlowControl.h
+ * @brief Flow control of UART1
+ *
+ * With FlowRtsCts, Rts_P3 is pulled high to stop the peer and Cts_P3 is
+ * polled every tick to hold the TX queue. With FlowXonXoff, XOFF and XON are
+ * sent ahead of the TX queue and the ones received hold the TX queue.
+ *
+ * Binary output, e.g. dumps and the sample stream, could hold XON or XOFF
+ * and stall the peer, so with FlowXonXoff the TX queue sends XON, XOFF and
+ * FlowEscape as FlowEscape followed by the byte xor FlowEscapeXor. The
+ * peer undoes it after dropping XON and XOFF, e.g. --xonxoff of the tools.
+ *
+ * The receive buffer is paused for reasons, e.g. being almost full or an
+ * erase stalling the CPU, and resumed once no reason is left.
+ */
+#pragma once
+#include "BoardBase.h"
+#include "STC/Interrupt.h"
+#include "STC/UART/TxQueue.h"
+#include "stdint.h"
+
+#define FlowNone 0
+#define FlowRtsCts 1
+#define FlowXonXoff 2
+
+/**
+ * @brief Flow control of UART1, FlowNone, FlowRtsCts or FlowXonXoff, could be set by -D
+ */
+#ifndef FlowControl
+#define FlowControl FlowNone
+#endif
+
+#define FlowXon 0x11
+#define FlowXoff 0x13
+
+/**
+ * @brief Escape of XON, XOFF and itself in the output with FlowXonXoff
+ */
+#define FlowEscape 0x7D
+#define FlowEscapeXor 0x20
+
+/**
+ * @brief Reasons to pause receiving
+ */
+#define RxPauseFull 0x01
+#define RxPauseErase 0x02
+
+/**
+ * @brief Reasons the peer is paused for, 0 if not paused
+ */
+extern uint8_t rxPauseReasons;
+
+/**
+ * @brief Set when txEscapedByte follows the FlowEscape being sent
+ */
+extern uint8_t txEscaped;
+extern uint8_t txEscapedByte;
+
+/**
+ * @brief Check if a byte of the TX queue must be escaped
+ *
+ * @param b byte to send
+ * @return non-zero to send FlowEscape and b ^ FlowEscapeXor instead
+ */
+inline int isFlowEscaped(uint8_t b)
+{
+#if FlowControl == FlowXonXoff
+    return b == FlowXon || b == FlowXoff || b == FlowEscape;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Tell the peer to stop or resume sending, call it with interrupts disabled
+ *
+ * @param stop non-zero to stop
+ */
+void signalFlow(uint8_t stop);
+
+/**
+ * @brief Check if the stop signal has left this node
+ *
+ * @return non-zero if sent
+ */
+inline int isFlowSignalled()
+{
+#if FlowControl == FlowXonXoff
+    return !txUrgent && !txBusy;
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief Ask the peer to stop sending, safe to call in isr
+ *
+ * @param reason one of RxPause*
+ */
+void pauseRx(uint8_t reason);
+
+/**
+ * @brief Let the peer send again once no reason is left, safe to call in isr
+ *
+ * @param reason one of RxPause*
+ */
+void resumeRx(uint8_t reason);
+
+/**
+ * @brief Take XON/XOFF sent by the peer, call it in isr on RI
+ *
+ * @param data received data
+ * @return non-zero if it was a flow control byte and should be dropped
+ */
+uint8_t filterFlowByte(uint8_t data);
+
+/**
+ * @brief Follow CTS of the peer, call it in the tick isr
+ */
+inline void pollFlow()
+{
+#if FlowControl == FlowRtsCts
+    if (txHeld != Cts_P3) setTxHeld(Cts_P3);
+#endif
+}
+
+/**
+ * @brief Let the peer send, call it before the port is configured
+ */
+void initFlowControl();
\ No newline at end of file
@@ -0,0 +1,151 @@
+/**
+ * @file RxFrame.h
+ * @brief Receive buffer of UART1 delimited into frames by idle line
+ *
+ * Every received byte rearms PCA module 0 to match RxIdleBits bit-times
+ * later. If no byte arrives meanwhile, the match ends the frame, so the
+ * consumer gets a whole burst at once instead of byte by byte.
+ *
+ * Once RxHighWater bytes are buffered the peer is paused, and resumed once
+ * the consumer drains the buffer down to RxLowWater.
+ */
+#pragma once
+#include "STC/Interrupt.h"
+#include "STC/PCA/PCA.h"
+#include "STC/UART/FlowControl.h"
+#include "stdint.h"
+
+/**
+ * @brief Size of the receive buffer, must be a power of 2
+ */
+#define RxRingSize 64
+
+/**
+ * @brief Bytes the peer could still send once asked to pause
+ *
+ * The byte being received, a FIFO of 16 bytes, and with XOFF the byte
+ * being sent ahead of it and XOFF itself
+ */
+#define RxPauseLagBytes (16 + 3)
+
+/**
+ * @brief Pause the peer when this many bytes are buffered, the rest holds RxPauseLagBytes
+ */
+#define RxHighWater (RxRingSize - RxPauseLagBytes)
+
+/**
+ * @brief Resume the peer when this many bytes are left
+ */
+#define RxLowWater (RxRingSize / 4)
+
+/**
+ * @brief Silence on RXD that ends a frame in bit-times
+ */
+#define RxIdleBits 20
+
+/**
+ * @brief PCA module timing the idle line
+ */
+#define RxIdleModule PCAModule0
+
+/**
+ * @brief Longest wait for the peer to pause before an erase in bit-times
+ *
+ * Long enough for RxPauseLagBytes and an idle line. It is capped to the
+ * wrap of the PCA counter, 71 ms, which is enough from 4800 baud up.
+ */
+#define RxErasePauseBits (RxPauseLagBytes * 10 + RxIdleBits)
+
+extern __xdata uint8_t rxRing[RxRingSize];
+
+extern uint8_t rxHead, rxTail;
+/**
+ * @brief rxTail when the last frame was completed
+ */
+extern uint8_t rxFrameEnd;
+/**
+ * @brief Bytes dropped because the buffer was full
+ */
+extern uint8_t rxDropped;
+/**
+ * @brief Silence that ends a frame in PCA ticks
+ */
+extern uint16_t rxIdleTicks;
+/**
+ * @brief Longest wait for the peer to pause before an erase in PCA ticks
+ */
+extern uint16_t rxErasePauseTicks;
+/**
+ * @brief PCA counter when the peer was asked to pause for an erase
+ */
+extern uint16_t rxErasePauseStart;
+/**
+ * @brief PCA counter when the pause for an erase was seen to have left this node, valid if rxEraseSignalled
+ */
+extern uint16_t rxEraseSignalTime;
+extern uint8_t  rxEraseSignalled;
+
+/**
+ * @brief Set up idle line detection, call it after the PCA is configured
+ *
+ * @param baud baud rate of the port
+ */
+void initRxFrame(uint32_t baud);
+
+/**
+ * @brief Buffer a received byte and restart the idle timer, call it in isr on RI
+ *
+ * @param data received data
+ */
+void onRxByte(uint8_t data);
+
+/**
+ * @brief Complete the frame, call it in isr on CCF of RxIdleModule
+ */
+void onRxIdle();
+
+/**
+ * @brief Take the oldest completed frame
+ *
+ * @param frame buffer to hold the frame
+ * @param maxLen size of the buffer, the rest of a longer frame is taken next time
+ * @return length of the frame, 0 if none is completed
+ */
+uint8_t takeRxFrame(uint8_t* frame, uint8_t maxLen);
+
+/**
+ * @brief Check if no byte is being received
+ *
+ * @return non-zero if the line has been idle for RxIdleBits since the last byte
+ */
+inline int isRxLineIdle()
+{
+    return rxFrameEnd == rxTail;
+}
+
+/**
+ * @brief Check if the peer has been paused and stopped sending
+ *
+ * @return non-zero if paused
+ */
+inline int isRxPaused()
+{
+    return rxPauseReasons && isFlowSignalled() && isRxLineIdle();
+}
+
+/**
+ * @brief Pause the peer before an erase stalls the CPU, set it as erasePauseHook
+ *
+ * A byte the peer started before the signal reached it is still on the
+ * line, so the line must also stay idle for rxIdleTicks after the signal
+ * has left.
+ *
+ * @param first non-zero on the first call for an erase
+ * @return non-zero once the peer is paused or waited for rxErasePauseTicks
+ */
+uint8_t pauseRxForErase(uint8_t first);
+
+/**
+ * @brief Let the peer send again after an erase, set it as eraseResumeHook
+ */
+void resumeRxAfterErase();
\ No newline at end of file
@@ -0,0 +1,101 @@
+/**
+ * @file TxFormat.h
+ * @brief Queue integers as decimal or hex text, written straight into the TX ring
+ *
+ * Hex digits come from a __code table, a nibble each. Decimal digits are
+ * counted by subtracting the powers of ten of a __code table, at most 9
+ * times per digit, so no division is linked in. Values up to 16 bits only
+ * use 16 bit subtractions.
+ *
+ * Nothing is queued unless the whole text fits, don't call them in isr.
+ */
+#pragma once
+#include "STC/UART/TxQueue.h"
+#include "stdint.h"
+
+/**
+ * @brief Most digits of each size, the ring must have that much room
+ */
+#define TxDec8Digits 3
+#define TxDec16Digits 5
+#define TxDec32Digits 10
+
+extern __code char txHexDigits[16];
+
+/**
+ * @brief 10000 down to 10
+ */
+extern __code uint16_t txDecPowers16[4];
+
+/**
+ * @brief 1000000000 down to 10000, the rest fits in 16 bits
+ */
+extern __code uint32_t txDecPowers32[6];
+
+/**
+ * @brief Stage the hex digits of bytes, the most significant first
+ *
+ * @param bytes little endian value, as SDCC stores it
+ * @param count size of the value
+ * @return how many digits are staged
+ */
+uint8_t stageHex(const uint8_t* bytes, uint8_t count);
+
+/**
+ * @brief Stage the decimal digits of a value
+ *
+ * @param value value below txDecPowers16[first] * 10
+ * @param at offset of the first digit
+ * @param first index of the first power in txDecPowers16
+ * @param zeros non-zero to keep leading zeros
+ * @return offset after the last digit
+ */
+uint8_t stageDec16(uint16_t value, uint8_t at, uint8_t first, uint8_t zeros);
+
+/**
+ * @brief Queue a value as 2 hex digits
+ *
+ * @param value value to send
+ * @return non-zero if queued
+ */
+uint8_t txPutHex8(uint8_t value);
+
+/**
+ * @brief Queue a value as 4 hex digits
+ *
+ * @param value value to send
+ * @return non-zero if queued
+ */
+uint8_t txPutHex16(uint16_t value);
+
+/**
+ * @brief Queue a value as 8 hex digits
+ *
+ * @param value value to send
+ * @return non-zero if queued
+ */
+uint8_t txPutHex32(uint32_t value);
+
+/**
+ * @brief Queue a value in decimal without leading zeros
+ *
+ * @param value value to send
+ * @return non-zero if queued
+ */
+uint8_t txPutDec8(uint8_t value);
+
+/**
+ * @brief Queue a value in decimal without leading zeros
+ *
+ * @param value value to send
+ * @return non-zero if queued
+ */
+uint8_t txPutDec16(uint16_t value);
+
+/**
+ * @brief Queue a value in decimal without leading zeros
+ *
+ * @param value value to send
+ * @return non-zero if queued
+ */
+uint8_t txPutDec32(uint32_t value);
\ No newline at end of file
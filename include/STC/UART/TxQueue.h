@@ -0,0 +1,255 @@
+/**
+ * @file TxQueue.h
+ * @brief Interrupt driven transmit queue of UART1
+ *
+ * The queue holds descriptors of where the next bytes come from, the TI
+ * isr pulls them one by one straight from the source:
+ * - bytes put into the ring buffer
+ * - memory, e.g. a string in __code, without copying it into RAM
+ * - EEPROM, through an IAP read cursor
+ */
+#pragma once
+#include "STC/IAP/IAP.h"
+#include "STC/Interrupt.h"
+#include "STC/UART/UART.h"
+#include "stdint.h"
+
+/**
+ * @brief Port the queue transmits through
+ */
+#define TxPort Port1
+
+/**
+ * @brief Size of the ring buffer, must be a power of 2
+ */
+#define TxRingSize 64
+
+/**
+ * @brief Max descriptors queued, must be a power of 2
+ */
+#define TxDescCount 8
+
+/**
+ * @brief Interrupts touching the queue, UART1 and Timer0 polling CTS
+ */
+#define TxInterrupts (InterruptUART1 | InterruptTimer0)
+
+/**
+ * @brief Stop the descriptor at the first \0 or erased byte
+ */
+#define TxStopAtNul 0x01
+
+typedef enum TxSource {
+    /**
+     * @brief Bytes put by txPutByte()
+     */
+    TxFromRing,
+    /**
+     * @brief Bytes at a generic pointer
+     */
+    TxFromMemory,
+    /**
+     * @brief Bytes in EEPROM
+     */
+    TxFromIAP
+} TxSource_t;
+
+typedef struct TxDesc
+{
+    TxSource_t src;
+    uint8_t    flags;
+    union
+    {
+        const char* mem;
+        uint16_t    iap;
+    } at;
+    /**
+     * @brief Remain bytes to send
+     */
+    uint16_t len;
+} TxDesc_t;
+
+extern __xdata uint8_t  txRing[TxRingSize];
+extern __xdata TxDesc_t txDescs[TxDescCount];
+
+extern uint8_t txRingHead, txRingTail;
+extern uint8_t txDescHead, txDescTail;
+/**
+ * @brief Set while a byte is being shifted out
+ */
+extern uint8_t txBusy;
+/**
+ * @brief Set to stop taking bytes from the queue, urgent bytes are still sent
+ */
+extern uint8_t txHeld;
+/**
+ * @brief Set when txUrgentByte should be sent before anything queued
+ */
+extern uint8_t txUrgent;
+extern uint8_t txUrgentByte;
+
+/**
+ * @brief Fetch the next byte to send
+ *
+ * @param out the next byte
+ * @return non-zero if there is one
+ */
+uint8_t nextTxByte(uint8_t* out);
+
+/**
+ * @brief Start sending if the port is idle, call it with TxInterrupts masked
+ */
+void kickTx();
+
+/**
+ * @brief Send a byte ahead of the queue, e.g. XON/XOFF, call it with TxInterrupts masked
+ *
+ * Replaces the urgent byte not sent yet
+ *
+ * @param b byte to send
+ */
+void txPutUrgent(uint8_t b);
+
+/**
+ * @brief Stop or resume taking bytes from the queue, call it with TxInterrupts masked
+ *
+ * The byte being shifted out is completed
+ *
+ * @param held non-zero to stop
+ */
+void setTxHeld(uint8_t held);
+
+/**
+ * @brief Call it in isr after TI is cleared
+ */
+void onTxReady();
+
+/**
+ * @brief Check if everything queued has been sent
+ *
+ * @return non-zero if idle
+ */
+inline int isTxIdle()
+{
+    return !txBusy && !txUrgent && txDescHead == txDescTail;
+}
+
+/**
+ * @brief Count free descriptors
+ *
+ * @return how many descriptors could be queued
+ */
+inline uint8_t txDescFree()
+{
+    return (txDescHead - txDescTail - 1) & (TxDescCount - 1);
+}
+
+/**
+ * @brief Count free bytes of the ring buffer
+ *
+ * @return how many bytes could be put
+ */
+inline uint8_t txRingFree()
+{
+    return TxRingSize - (uint8_t)(txRingTail - txRingHead);
+}
+
+/**
+ * @brief Get the last descriptor queued, to check with isTxDescSent()
+ *
+ * @return index of the descriptor
+ */
+inline uint8_t lastTxDesc()
+{
+    return (txDescTail - 1) & (TxDescCount - 1);
+}
+
+/**
+ * @brief Check if a descriptor is sent, check it before TxDescCount more are queued
+ *
+ * @param desc index returned by lastTxDesc()
+ * @return non-zero if sent
+ */
+inline int isTxDescSent(uint8_t desc)
+{
+    return ((desc - txDescHead) & (TxDescCount - 1)) >= ((txDescTail - txDescHead) & (TxDescCount - 1));
+}
+
+/**
+ * @brief Append a descriptor, call it with TxInterrupts masked
+ *
+ * @return the descriptor, null if the queue is full
+ */
+__xdata TxDesc_t* pushTxDesc(TxSource_t src, uint8_t flags, uint16_t len);
+
+/**
+ * @brief Commit the descriptor returned by pushTxDesc() and start sending
+ */
+inline void commitTxDesc()
+{
+    txDescTail = (txDescTail + 1) & (TxDescCount - 1);
+    kickTx();
+}
+
+/**
+ * @brief Queue a byte, call it from the main loop
+ *
+ * @param b byte to send
+ * @return non-zero if queued
+ */
+uint8_t txPutByte(uint8_t b);
+
+/**
+ * @brief Write a byte past the end of the ring, it is sent once committed by txCommitStaged()
+ *
+ * Don't call it in isr, nor while an isr may put bytes into the ring.
+ *
+ * @param at offset from the end of the ring, below txRingFree()
+ * @param b byte to write
+ */
+inline void txStageByte(uint8_t at, uint8_t b)
+{
+    txRing[(uint8_t)(txRingTail + at) & (TxRingSize - 1)] = b;
+}
+
+/**
+ * @brief Queue the bytes written by txStageByte()
+ *
+ * @param len how many bytes, at most txRingFree()
+ * @return non-zero if queued, the staged bytes are dropped otherwise
+ */
+uint8_t txCommitStaged(uint8_t len);
+
+/**
+ * @brief Queue the header of a dump through the ring, the body is queued right after it
+ *
+ * Don't call it in isr. No isr queues descriptors, so once the header is
+ * queued, the bodyDescs descriptors of the body are still free. Nothing is
+ * queued unless the header and the body fit.
+ *
+ * @param header bytes of the header
+ * @param len length of the header
+ * @param bodyDescs descriptors the body takes
+ * @return non-zero if queued
+ */
+uint8_t txPutHeader(const uint8_t* header, uint8_t len, uint8_t bodyDescs);
+
+/**
+ * @brief Queue bytes in memory without copying, call it from the main loop
+ *
+ * @param mem bytes to send, must stay unchanged until sent
+ * @param len length to send
+ * @param flags TxStopAtNul or 0
+ * @return non-zero if queued
+ */
+uint8_t txPutMemory(const char* mem, uint16_t len, uint8_t flags);
+
+/**
+ * @brief Queue bytes in EEPROM without copying, call it from the main loop
+ *
+ * @param addr address of the bytes
+ * @param len length to send
+ * @param flags TxStopAtNul or 0
+ * @return non-zero if queued
+ */
+uint8_t txPutIAP(uint16_t addr, uint16_t len, uint8_t flags);
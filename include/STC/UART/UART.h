@@ -87,12 +87,34 @@ typedef struct PortCfg
 } PortCfg_t, *pPortCfg;
 
 /**
- * @brief Configure Serial Port
+ * @brief Register images of a port computed at compile time from PortCfg_t field values
+ *
+ * Timer_1 also needs Timer1 to be started, BRT is started by PortAUXRImage().
+ * REN and S2REN are left to be set once the receiver is ready.
+ */
+#define PortSCONImage(mode, baudGen) \
+    (((mode) != UART8 ? 0x80 : 0x00) | ((baudGen) != SysClk ? 0x40 : 0x00) | ((mode) == EUART ? 0x20 : 0x00))
+#define PortS2CONImage(mode, baudGen) \
+    (((mode) != UART8 ? 0x80 : 0x00) | ((baudGen) == Timer_BRT ? 0x40 : 0x00) | ((mode) == EUART ? 0x20 : 0x00))
+#define PortAUXRImage(port, baudGen, baudMode)                                    \
+    (((baudGen) == Timer_BRT ? ((port) == Port1 ? 0x11 : 0x10) : 0x00) |          \
+     ((port) == Port2 && (baudMode) == Double ? 0x08 : 0x00))
+#define PortPCONImage(port, baudMode) ((port) == Port1 && (baudMode) == Double ? 0x80 : 0x00)
+#define PortIEImage(port, it) ((port) == Port1 && (it) == EnableIT ? 0x10 : 0x00)
+#define PortIE2Image(port, it) ((port) == Port2 && (it) == EnableIT ? 0x01 : 0x00)
+
+/**
+ * @brief Register image selecting the trigger source of BRT
+ */
+#define BRTAUXRImage(source) ((source) == SysClock_DIV_1 ? 0x04 : 0x00)
+
+/**
+ * @brief Configure Serial Port at runtime, prefer the images where the configuration is constant
  *
  * @param port which port to config
  * @param cfg configuration
  */
-void configurePort(UARTPort_t port, pPortCfg cfg)
+inline void configurePort(UARTPort_t port, pPortCfg cfg)
 {
     switch (port) {
         case Port1:
@@ -103,7 +125,7 @@ void configurePort(UARTPort_t port, pPortCfg cfg)
                 case EUART:
                     // Select Address at initial
                     SM2 = 1;
-                case UART9: SM1 = 1; break;
+                case UART9: SM0 = 1; break;
             }
             switch (cfg->baudGen) {
                 case Timer_1:
@@ -248,10 +270,14 @@ inline void sendDataTI(UARTPort_t port, uint8_t data)
  */
 inline void sendData(UARTPort_t port, uint8_t data)
 {
-    disableGlobalInterrupt();
+    // The isr of the port would clear TI before it is seen
+    uint8_t enabled  = maskInterrupt(PortIEImage(port, EnableIT));
+    uint8_t enabled2 = IE2 & PortIE2Image(port, EnableIT);
+    IE2 &= ~PortIE2Image(port, EnableIT);
     writePort(port, data);
     while (!checkTI(port))
         ;
     clearTI(port);
-    enableGlobalInterrupt();
+    IE2 |= enabled2;
+    unmaskInterrupt(enabled);
 }
\ No newline at end of file
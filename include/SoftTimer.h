@@ -0,0 +1,151 @@
+/**
+ * @file SoftTimer.h
+ * @brief Software timers driven by the 1 ms tick
+ *
+ * Timers are kept in a two level timing wheel. Level 0 has a slot for each of
+ * the next SoftWheelSlots ticks, level 1 has a slot for each of the next
+ * SoftWheelSlots rounds of level 0. A tick only visits one slot of level 0,
+ * and once a round cascades one slot of level 1 down, so start and cancel
+ * are O(1) and the tick is amortised O(1) no matter how many timers run.
+ *
+ * Timers come from a static pool of SoftTimerCount, callbacks run in the
+ * tick isr. The wheel is only changed with interrupts disabled, since the
+ * LVD isr may start or cancel timers while the tick isr runs.
+ */
+#pragma once
+#include "STC/Interrupt.h"
+#include "stdint.h"
+
+/**
+ * @brief Size of the timer pool
+ */
+#define SoftTimerCount 8
+
+/**
+ * @brief Bits of ticks covered by a level of the wheel
+ */
+#define SoftWheelBits 6
+#define SoftWheelSlots (1 << SoftWheelBits)
+#define SoftWheelMask (SoftWheelSlots - 1)
+
+/**
+ * @brief Marks the end of a list, a timer not queued or an invalid id
+ */
+#define SoftTimerNone 0xFF
+
+/**
+ * @brief Slot of a timer expired in this tick, whose callback is not called yet
+ */
+#define SoftTimerFiring 0xFE
+
+typedef void (*SoftTimerCallback_t)();
+
+typedef struct SoftTimer
+{
+    SoftTimerCallback_t callback;
+    /**
+     * @brief Tick when the timer expires
+     */
+    uint16_t            expires;
+    uint8_t             next;
+    uint8_t             prev;
+    /**
+     * @brief Slot of the wheel holding the timer, level 1 slots follow level 0 ones
+     */
+    uint8_t             slot;
+} SoftTimer_t;
+
+extern __xdata SoftTimer_t softTimers[SoftTimerCount];
+
+/**
+ * @brief First timer of each slot, level 0 then level 1
+ */
+extern __xdata uint8_t softWheel[SoftWheelSlots * 2];
+
+/**
+ * @brief Timers created from the pool
+ */
+extern uint8_t softTimerUsed;
+
+/**
+ * @brief Milliseconds passed since the wheel started
+ */
+extern uint32_t sysTickMs;
+
+/**
+ * @brief Empty the wheel, call it once before any other method
+ */
+void initSoftTimer();
+
+/**
+ * @brief Read sysTickMs outside of the tick isr
+ *
+ * @return milliseconds passed since the wheel started
+ */
+uint32_t getSysTickMs();
+
+/**
+ * @brief Take a timer from the pool, call it at initialization
+ *
+ * @param callback called in the tick isr when the timer expires
+ * @return id of the timer, SoftTimerNone if the pool is empty
+ */
+uint8_t createSoftTimer(SoftTimerCallback_t callback);
+
+/**
+ * @brief Put a timer into the slot matching its expiry, call it with interrupts disabled
+ *
+ * @param id id of the timer
+ */
+void queueSoftTimer(uint8_t id);
+
+/**
+ * @brief Take a timer out of its slot, call it with interrupts disabled
+ *
+ * @param id id of the timer
+ */
+void unqueueSoftTimer(uint8_t id);
+
+/**
+ * @brief Start or restart a timer, safe to call in isr
+ *
+ * @param id id of the timer
+ * @param delayMs expires after this long in millisecond, at least 1
+ */
+void startSoftTimer(uint8_t id, uint16_t delayMs);
+
+/**
+ * @brief Stop a timer, safe to call in isr
+ *
+ * @param id id of the timer
+ */
+void cancelSoftTimer(uint8_t id);
+
+/**
+ * @brief Check if a timer is running
+ *
+ * @param id id of the timer
+ * @return non-zero if running
+ */
+inline int isSoftTimerRunning(uint8_t id)
+{
+    return softTimers[id].slot != SoftTimerNone;
+}
+
+/**
+ * @brief Detach every timer of a slot
+ *
+ * @param slot slot to detach
+ * @return first timer of the detached list
+ */
+inline uint8_t takeSoftWheelSlot(uint8_t slot)
+{
+    uint8_t first   = softWheel[slot];
+    softWheel[slot] = SoftTimerNone;
+    return first;
+}
+
+/**
+ * @brief Call this method every one millisecond to expire timers
+ */
+void onSoftTimerTick();
@@ -0,0 +1,35 @@
+/**
+ * @file StatusReport.h
+ * @brief Report counters and levels as a line of text
+ *
+ * The line is StatusMagic, then in decimal and separated by spaces: the
+ * uptime in ms, the bytes dropped by RX, the sample frames dropped and the
+ * supply level, e.g. "S 15327 0 2 812\n". The level is sampled for the
+ * report unless a stream keeps it fresh.
+ */
+#pragma once
+#include "ADCSampler.h"
+#include "STC/UART/RxFrame.h"
+#include "STC/UART/TxFormat.h"
+#include "STC/UART/TxQueue.h"
+#include "SoftTimer.h"
+#include "stdint.h"
+
+/**
+ * @brief Request to report
+ */
+#define StatusRequest '='
+
+#define StatusMagic 'S'
+
+/**
+ * @brief Longest line
+ */
+#define StatusMaxSize (1 + 1 + TxDec32Digits + 1 + TxDec8Digits + 1 + TxDec8Digits + 1 + TxDec16Digits + 1)
+
+/**
+ * @brief Queue the line, call it when the TX queue has a free descriptor
+ *
+ * @return non-zero if queued, zero to retry until the ring has room and the level is sampled
+ */
+uint8_t sendStatus();
\ No newline at end of file
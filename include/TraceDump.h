@@ -0,0 +1,37 @@
+/**
+ * @file TraceDump.h
+ * @brief Send the trace ring through the TX queue, decoded by tools/trace_decode.py
+ *
+ * The dump is TraceDumpMagic, the record count, then the records oldest
+ * first, 3 bytes each: the event and the little endian PCA counter. The ring
+ * is frozen until the dump is sent, and restarts empty.
+ */
+#pragma once
+#include "STC/Trace.h"
+#include "STC/UART/TxQueue.h"
+#include "stdint.h"
+
+/**
+ * @brief Request to dump the trace
+ */
+#define TraceDumpRequest '#'
+
+/**
+ * @brief Starts a dump
+ */
+#define TraceDumpMagic 'T'
+#define TraceDumpHeaderSize 2
+
+/**
+ * @brief Send the ring, call it when the TX queue has 3 free descriptors
+ *
+ * Nothing is queued unless the whole dump fits, the ring then keeps recording.
+ *
+ * @return non-zero if queued
+ */
+uint8_t dumpTrace();
+
+/**
+ * @brief Restart the trace once the dump is sent, call it from the main loop
+ */
+void stepTrace();
\ No newline at end of file
@@ -0,0 +1,79 @@
+/**
+ * @file WriteBackCache.h
+ * @brief Hold the newest record in RAM and write it back to the record log lazily
+ *
+ * A dirty record is appended when no update arrives for CacheQuietMs,
+ * when it has been dirty for CacheMaxAgeMs, or at once by onLowVoltage().
+ */
+#pragma once
+#include "EEPROMCommitter.h"
+#include "RecordStore.h"
+#include "STC/Interrupt.h"
+#include "SoftTimer.h"
+#include "stdint.h"
+
+/**
+ * @brief Commit after no update arrives for this long in millisecond
+ */
+#define CacheQuietMs 200
+
+/**
+ * @brief Commit after the record stays dirty for this long in millisecond
+ */
+#define CacheMaxAgeMs 2000
+
+extern __xdata uint8_t cacheData[RecordLogMaxSize];
+
+extern uint8_t cacheLen;
+/**
+ * @brief Set when cacheData is newer than the one in EEPROM
+ */
+extern uint8_t cacheDirty;
+/**
+ * @brief Expires after CacheQuietMs without update
+ */
+extern uint8_t cacheQuietTimer;
+/**
+ * @brief Expires after the record stays dirty for CacheMaxAgeMs
+ */
+extern uint8_t cacheAgeTimer;
+
+/**
+ * @brief Hand the dirty record over to the record log
+ *
+ * @return non-zero if nothing is dirty anymore
+ */
+uint8_t flushCache();
+
+/**
+ * @brief Update the cached record, safe to call in isr
+ *
+ * @param data encoded record
+ * @param len size of the record
+ * @return non-zero if cached
+ */
+uint8_t cacheRecord(const uint8_t* data, uint8_t len);
+
+/**
+ * @brief Called in the tick isr when the quiet time or the max age is reached
+ */
+void onCacheExpired();
+
+/**
+ * @brief Hand the dirty record over once the pending appends are committed, called by urgeCommit()
+ */
+void onCacheUrged();
+
+/**
+ * @brief Take the timers of the cache, call it after initSoftTimer()
+ */
+void initCache();
+
+/**
+ * @brief Persist the dirty record before power is lost, call it from the LVD isr
+ *
+ * The previous append is finished first to make room for the dirty record,
+ * which is then appended and committed through commitUrgeHook. If the main
+ * loop holds IAP, releaseIAP() does both as soon as the isr returns.
+ */
+void onLowVoltage();
@@ -0,0 +1,16 @@
+#include "STC/ADC/ADC.h"
+
+void configureADC(pADCCfg cfg)
+{
+    // Analog inputs as high impedance
+    P1M1 |= cfg->inputs;
+    P1M0 &= ~cfg->inputs;
+    P1ASF = cfg->inputs;
+    // High 8 bits in ADC_RES, low 2 bits in ADC_RESL
+    AUXR1 &= 0xFB;
+    ADC_CONTR = 0x80 | cfg->speed << 5;
+    switch (cfg->it) {
+        case EnableIT: EADC = 1; break;
+        case DisableIT: EADC = 0; break;
+    }
+}
\ No newline at end of file
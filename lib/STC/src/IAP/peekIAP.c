@@ -0,0 +1,27 @@
+#pragma nooverlay
+#include "STC/IAP/IAP.h"
+
+uint8_t peekIAP(uint16_t addr)
+{
+    uint8_t         addrH, addrL, data, cmd, contr;
+    uint8_t         result;
+    // The LVD isr may commit between setting the address and reading
+    CriticalState_t state = enterCritical();
+
+    addrH = IAP_ADDRH;
+    addrL = IAP_ADDRL;
+    data  = IAP_DATA;
+    cmd   = IAP_CMD;
+    contr = IAP_CONTR;
+
+    writeIAPAddr(addr);
+    result = readFromIAP();
+
+    IAP_ADDRH = addrH;
+    IAP_ADDRL = addrL;
+    IAP_DATA  = data;
+    IAP_CMD   = cmd;
+    IAP_CONTR = contr;
+    exitCritical(state);
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#include "STC/PCA/PCA.h"
+
+void configurePCA(pPCACfg cfg)
+{
+    CR   = 0;
+    CF   = 0;
+    CL   = 0;
+    CH   = 0;
+    CMOD = (cfg->runInIdle ? 0x00 : 0x80) | cfg->source << 1 | (cfg->overflowIT == EnableIT);
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#include "STC/PCA/PCA.h"
+
+void configurePCAModule(PCAModule_t module, PCAMode_t mode, Interrupt_t it)
+{
+    uint8_t value;
+    switch (mode) {
+        case PCADisabled: value = 0x00; break;
+        case PCASoftTimer: value = 0x48; break;
+        case PCAHighSpeedOutput: value = 0x4C; break;
+        case PCAPWM: value = 0x42; break;
+        case PCACaptureRising: value = 0x20; break;
+        case PCACaptureFalling: value = 0x10; break;
+        case PCACaptureBoth: value = 0x30; break;
+        default: value = 0x00; break;
+    }
+    if (it == EnableIT) value |= 0x01;
+    switch (module) {
+        case PCAModule0: CCAPM0 = value; break;
+        case PCAModule1: CCAPM1 = value; break;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "STC/SPI/SPI.h"
+
+const uint8_t* spiTx;
+uint8_t*       spiRx;
+uint16_t       spiLen;
+SPICallback_t  spiOnDone;
+uint8_t        spiBusy;
\ No newline at end of file
@@ -0,0 +1,12 @@
+#include "STC/SPI/SPI.h"
+
+void configureSPI(pSPICfg cfg)
+{
+    // MOSI/P1.5 and SPICLK/P1.7 as push-pull
+    P1M1 &= 0x5F;
+    P1M0 |= 0xA0;
+    // SSIG, SPEN, MSTR
+    SPCTL = 0xD0 | (cfg->lsbFirst ? 0x20 : 0x00) | cfg->mode << 2 | cfg->clock;
+    SPSTAT = 0xC0;
+    IE2 &= 0xFD;
+}
\ No newline at end of file
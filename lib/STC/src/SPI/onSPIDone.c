@@ -0,0 +1,15 @@
+#pragma nooverlay
+#include "STC/SPI/SPI.h"
+
+void onSPIDone()
+{
+    clearSPIF();
+    if (spiRx) *spiRx++ = SPDAT;
+    if (--spiLen) {
+        SPDAT = spiTx ? *spiTx++ : 0xFF;
+        return;
+    }
+    IE2 &= 0xFD;
+    spiBusy = 0;
+    if (spiOnDone) spiOnDone();
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#include "STC/SPI/SPI.h"
+
+void startSPITransfer(const uint8_t* tx, uint8_t* rx, uint16_t len, SPICallback_t onDone)
+{
+    spiTx     = tx;
+    spiRx     = rx;
+    spiLen    = len;
+    spiOnDone = onDone;
+    spiBusy   = 1;
+    IE2 |= 0x02;
+    SPDAT = spiTx ? *spiTx++ : 0xFF;
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma nooverlay
+#include "STC/SPI/SPI.h"
+
+uint8_t transferSPI(uint8_t data)
+{
+    SPDAT = data;
+    while (!checkSPIF())
+        ;
+    clearSPIF();
+    return SPDAT;
+}
\ No newline at end of file
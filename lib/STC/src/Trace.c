@@ -0,0 +1,9 @@
+#include "STC/Trace.h"
+
+#if TraceEnabled
+__xdata TraceRecord_t traceRing[TraceRingSize];
+
+uint8_t traceHead;
+uint8_t traceWrapped;
+uint8_t traceFrozen;
+#endif
\ No newline at end of file
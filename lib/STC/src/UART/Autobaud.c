@@ -0,0 +1,8 @@
+#include "STC/UART/Autobaud.h"
+
+__code AutobaudRate_t autobaudRates[AutobaudRateCount] = {
+    AutobaudRate(1200),  AutobaudRate(2400),  AutobaudRate(4800),  AutobaudRate(9600),  AutobaudRate(14400),
+    AutobaudRate(19200), AutobaudRate(28800), AutobaudRate(38400), AutobaudRate(57600), AutobaudRate(115200),
+};
+
+uint8_t autobaudOverflows;
\ No newline at end of file
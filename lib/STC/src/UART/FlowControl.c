@@ -0,0 +1,5 @@
+#include "STC/UART/FlowControl.h"
+
+uint8_t rxPauseReasons;
+uint8_t txEscaped;
+uint8_t txEscapedByte;
\ No newline at end of file
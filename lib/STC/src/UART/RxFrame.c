@@ -0,0 +1,12 @@
+#include "STC/UART/RxFrame.h"
+
+__xdata uint8_t rxRing[RxRingSize];
+
+uint8_t  rxHead, rxTail;
+uint8_t  rxFrameEnd;
+uint8_t  rxDropped;
+uint16_t rxIdleTicks;
+uint16_t rxErasePauseTicks;
+uint16_t rxErasePauseStart;
+uint16_t rxEraseSignalTime;
+uint8_t  rxEraseSignalled;
\ No newline at end of file
@@ -0,0 +1,5 @@
+#include "STC/UART/TxFormat.h"
+
+__code char     txHexDigits[16]  = "0123456789ABCDEF";
+__code uint16_t txDecPowers16[4] = {10000, 1000, 100, 10};
+__code uint32_t txDecPowers32[6] = {1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL, 10000UL};
\ No newline at end of file
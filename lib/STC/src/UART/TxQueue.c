@@ -0,0 +1,11 @@
+#include "STC/UART/TxQueue.h"
+
+__xdata uint8_t  txRing[TxRingSize];
+__xdata TxDesc_t txDescs[TxDescCount];
+
+uint8_t txRingHead, txRingTail;
+uint8_t txDescHead, txDescTail;
+uint8_t txBusy;
+uint8_t txHeld;
+uint8_t txUrgent;
+uint8_t txUrgentByte;
\ No newline at end of file
@@ -0,0 +1,20 @@
+#include "STC/UART/Autobaud.h"
+
+uint8_t confirmAutobaud()
+{
+    uint16_t start;
+    uint8_t  locked;
+
+    // RXD is low in the last data bit, the next falling edge starts the next byte
+    clearRI(Port1);
+    REN   = 1;
+    start = readPCACounter();
+    while (!checkRI(Port1) && (uint16_t)(readPCACounter() - start) < AutobaudConfirmTicks)
+        ;
+    locked = checkRI(Port1) && readPort(Port1) == AutobaudSync;
+    clearRI(Port1);
+    // Kept receiving once locked, a sync byte sent meanwhile is dropped by settleAutobaud()
+    if (!locked) REN = 0;
+    if (locked) sendData(Port1, AutobaudAck);
+    return locked;
+}
\ No newline at end of file
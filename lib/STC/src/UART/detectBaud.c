@@ -0,0 +1,32 @@
+#include "STC/UART/Autobaud.h"
+
+uint32_t detectBaud(uint32_t fallback)
+{
+    __code AutobaudRate_t* rate;
+    uint16_t               attempts, clocksPerBit;
+    uint8_t                enabled, reload, brt1T;
+
+#if SimBaudTimer1
+    reload = TH1;
+    brt1T  = 0;
+#else
+    reload = BRT;
+    brt1T  = AUXR & 0x04;
+#endif
+
+    for (attempts = 0; attempts < AutobaudAttempts; attempts++) {
+        enabled      = maskInterrupt(AutobaudInterrupts);
+        clocksPerBit = measureAutobaudBit();
+        unmaskInterrupt(enabled);
+        if (!clocksPerBit) continue;
+        rate = findAutobaudRate(clocksPerBit);
+        if (!rate) continue;
+        loadAutobaudRate(rate->reload, rate->brt1T);
+        if (confirmAutobaud()) {
+            settleAutobaud();
+            return rate->baud;
+        }
+    }
+    loadAutobaudRate(reload, brt1T);
+    return fallback;
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma nooverlay
+#include "STC/UART/FlowControl.h"
+
+uint8_t filterFlowByte(uint8_t data)
+{
+#if FlowControl == FlowXonXoff
+    switch (data) {
+        case FlowXoff: setTxHeld(1); return 1;
+        case FlowXon: setTxHeld(0); return 1;
+    }
+#endif
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#include "STC/UART/Autobaud.h"
+
+__code AutobaudRate_t* findAutobaudRate(uint16_t clocksPerBit)
+{
+    __code AutobaudRate_t* rate;
+    uint16_t               error;
+    uint8_t                i;
+
+    for (i = 0; i < AutobaudRateCount; i++) {
+        rate  = &autobaudRates[i];
+        error = clocksPerBit > rate->clocksPerBit ? clocksPerBit - rate->clocksPerBit : rate->clocksPerBit - clocksPerBit;
+        if (error <= rate->clocksPerBit >> AutobaudToleranceBits) return rate;
+    }
+    return 0;
+}
\ No newline at end of file
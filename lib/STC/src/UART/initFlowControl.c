@@ -0,0 +1,11 @@
+#include "STC/UART/FlowControl.h"
+
+void initFlowControl()
+{
+    rxPauseReasons = 0;
+    txEscaped      = 0;
+#if FlowControl == FlowRtsCts
+    Rts_P3 = 0;
+    txHeld = Cts_P3;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#include "STC/UART/RxFrame.h"
+
+void initRxFrame(uint32_t baud)
+{
+    uint32_t ticks = PCAClock / baud * RxErasePauseBits;
+
+    rxIdleTicks       = BitsToPCATicks(RxIdleBits, baud);
+    rxErasePauseTicks = ticks > 0xFFFF ? 0xFFFF : ticks;
+    configurePCAModule(RxIdleModule, PCASoftTimer, EnableIT);
+    disarmPCAModule(RxIdleModule);
+}
\ No newline at end of file
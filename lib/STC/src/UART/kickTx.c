@@ -0,0 +1,29 @@
+#pragma nooverlay
+#include "STC/UART/FlowControl.h"
+
+void kickTx()
+{
+    uint8_t b;
+    if (txBusy) return;
+    if (txUrgent) {
+        txUrgent = 0;
+        b        = txUrgentByte;
+    }
+#if FlowControl == FlowXonXoff
+    // Second half of an escape, not held back so the pair stays whole
+    else if (txEscaped) {
+        txEscaped = 0;
+        b         = txEscapedByte;
+    }
+#endif
+    else {
+        if (txHeld || !nextTxByte(&b)) return;
+        if (isFlowEscaped(b)) {
+            txEscapedByte = b ^ FlowEscapeXor;
+            txEscaped     = 1;
+            b             = FlowEscape;
+        }
+    }
+    txBusy = 1;
+    writePort(TxPort, b);
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#include "STC/UART/Autobaud.h"
+
+void loadAutobaudRate(uint8_t reload, uint8_t brt1T)
+{
+#if SimBaudTimer1
+    (void)brt1T;
+    TR1  = 0;
+    TMOD = (TMOD & 0x0F) | TimerTMODImage(Timer1, SysClock_DIV_12, Counter_BIT_8_AutoReload, Ignore);
+    TL1  = reload;
+    TH1  = reload;
+    TR1  = 1;
+#else
+    stopBRT();
+    setBRTSource(brt1T ? SysClock_DIV_1 : SysClock_DIV_12);
+    reloadBRT(reload);
+    startBRT();
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#include "STC/UART/Autobaud.h"
+
+uint16_t measureAutobaudBit()
+{
+    uint8_t i, ok;
+
+    restartAutobaudTimer();
+    // Idle high, then the falling edge of the start bit
+    ok = waitAutobaudRxd(1, AutobaudWaitOverflows) && waitAutobaudRxd(0, AutobaudWaitOverflows);
+    TL1               = 0;
+    TH1               = 0;
+    TF1               = 0;
+    autobaudOverflows = 0;
+    // 8 bits at 1200 baud overflow once
+    for (i = 0; ok && i < 4; i++)
+        ok = waitAutobaudRxd(1, 2) && waitAutobaudRxd(0, 2);
+    TR1 = 0;
+    if (!ok) return 0;
+    if (TF1) autobaudOverflows++;
+    return ((uint32_t)autobaudOverflows << 16 | (uint16_t)TH1 << 8 | TL1) * AutobaudTimerClocks >> 3;
+}
\ No newline at end of file
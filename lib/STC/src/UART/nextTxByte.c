@@ -0,0 +1,29 @@
+#pragma nooverlay
+#include "STC/UART/TxQueue.h"
+
+uint8_t nextTxByte(uint8_t* out)
+{
+    __xdata TxDesc_t* desc;
+    uint8_t           b;
+
+    while (txDescHead != txDescTail) {
+        desc = &txDescs[txDescHead];
+        if (desc->len) {
+            desc->len--;
+            switch (desc->src) {
+                case TxFromRing: b = txRing[txRingHead++ & (TxRingSize - 1)]; break;
+                case TxFromMemory: b = *desc->at.mem++; break;
+                case TxFromIAP: b = peekIAP(desc->at.iap++); break;
+                default: b = 0; break;
+            }
+            if ((desc->flags & TxStopAtNul) && (b == '\0' || b == 0xFF)) {
+                desc->len = 0;
+                continue;
+            }
+            *out = b;
+            return 1;
+        }
+        txDescHead = (txDescHead + 1) & (TxDescCount - 1);
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma nooverlay
+#include "STC/UART/RxFrame.h"
+
+void onRxByte(uint8_t data)
+{
+    if (filterFlowByte(data)) return;
+    if ((uint8_t)(rxTail - rxHead) == RxRingSize) {
+        rxDropped++;
+        return;
+    }
+    rxRing[rxTail++ & (RxRingSize - 1)] = data;
+    setPCACompare(RxIdleModule, readPCACounter() + rxIdleTicks);
+    if ((uint8_t)(rxTail - rxHead) == RxHighWater) pauseRx(RxPauseFull);
+}
\ No newline at end of file
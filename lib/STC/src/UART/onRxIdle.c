@@ -0,0 +1,8 @@
+#pragma nooverlay
+#include "STC/UART/RxFrame.h"
+
+void onRxIdle()
+{
+    disarmPCAModule(RxIdleModule);
+    rxFrameEnd = rxTail;
+}
\ No newline at end of file
@@ -0,0 +1,8 @@
+#pragma nooverlay
+#include "STC/UART/TxQueue.h"
+
+void onTxReady()
+{
+    txBusy = 0;
+    kickTx();
+}
\ No newline at end of file
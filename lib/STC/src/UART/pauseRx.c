@@ -0,0 +1,10 @@
+#pragma nooverlay
+#include "STC/UART/FlowControl.h"
+
+void pauseRx(uint8_t reason)
+{
+    CriticalState_t state = enterCritical();
+    if (!rxPauseReasons) signalFlow(1);
+    rxPauseReasons |= reason;
+    exitCritical(state);
+}
\ No newline at end of file
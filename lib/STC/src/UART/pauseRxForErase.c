@@ -0,0 +1,24 @@
+#pragma nooverlay
+#include "STC/UART/RxFrame.h"
+
+uint8_t pauseRxForErase(uint8_t first)
+{
+    uint16_t now = readPCACounter();
+
+    if (first) {
+        rxErasePauseStart = now;
+        rxEraseSignalled  = 0;
+        pauseRx(RxPauseErase);
+    }
+#if FlowControl != FlowNone
+    if ((uint16_t)(now - rxErasePauseStart) >= rxErasePauseTicks) return 1;
+    if (!isFlowSignalled()) return 0;
+    if (!rxEraseSignalled) {
+        rxEraseSignalled  = 1;
+        rxEraseSignalTime = now;
+    }
+    return isRxLineIdle() && (uint16_t)(now - rxEraseSignalTime) >= rxIdleTicks;
+#else
+    return 1;
+#endif
+}
\ No newline at end of file
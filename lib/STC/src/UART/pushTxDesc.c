@@ -0,0 +1,14 @@
+#include "STC/UART/TxQueue.h"
+
+__xdata TxDesc_t* pushTxDesc(TxSource_t src, uint8_t flags, uint16_t len)
+{
+    __xdata TxDesc_t* desc;
+    uint8_t           next = (txDescTail + 1) & (TxDescCount - 1);
+
+    if (next == txDescHead) return 0;
+    desc        = &txDescs[txDescTail];
+    desc->src   = src;
+    desc->flags = flags;
+    desc->len   = len;
+    return desc;
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma nooverlay
+#include "STC/UART/FlowControl.h"
+
+void resumeRx(uint8_t reason)
+{
+    CriticalState_t state = enterCritical();
+    if (rxPauseReasons & reason) {
+        rxPauseReasons &= ~reason;
+        if (!rxPauseReasons) signalFlow(0);
+    }
+    exitCritical(state);
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma nooverlay
+#include "STC/UART/RxFrame.h"
+
+void resumeRxAfterErase()
+{
+    resumeRx(RxPauseErase);
+}
\ No newline at end of file
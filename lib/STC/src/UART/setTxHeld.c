@@ -0,0 +1,8 @@
+#pragma nooverlay
+#include "STC/UART/TxQueue.h"
+
+void setTxHeld(uint8_t held)
+{
+    txHeld = held;
+    if (!held) kickTx();
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#include "STC/UART/Autobaud.h"
+
+void settleAutobaud()
+{
+    uint16_t start;
+
+    start = readPCACounter();
+    while ((uint16_t)(readPCACounter() - start) < AutobaudSettleTicks) {
+        if (!checkRI(Port1)) continue;
+        // Left for the isr
+        if (readPort(Port1) != AutobaudSync) return;
+        clearRI(Port1);
+        start = readPCACounter();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma nooverlay
+#include "STC/UART/FlowControl.h"
+
+void signalFlow(uint8_t stop)
+{
+#if FlowControl == FlowRtsCts
+    Rts_P3 = stop ? 1 : 0;
+#elif FlowControl == FlowXonXoff
+    txPutUrgent(stop ? FlowXoff : FlowXon);
+#endif
+}
\ No newline at end of file
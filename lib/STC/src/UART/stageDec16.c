@@ -0,0 +1,22 @@
+#include "STC/UART/TxFormat.h"
+
+uint8_t stageDec16(uint16_t value, uint8_t at, uint8_t first, uint8_t zeros)
+{
+    uint16_t power;
+    uint8_t  digit;
+
+    for (; first < 4; first++) {
+        power = txDecPowers16[first];
+        digit = 0;
+        while (value >= power) {
+            value -= power;
+            digit++;
+        }
+        if (digit || zeros) {
+            txStageByte(at++, '0' + digit);
+            zeros = 1;
+        }
+    }
+    txStageByte(at++, '0' + value);
+    return at;
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#include "STC/UART/TxFormat.h"
+
+uint8_t stageHex(const uint8_t* bytes, uint8_t count)
+{
+    uint8_t at = 0, b;
+
+    while (count--) {
+        b = bytes[count];
+        txStageByte(at++, txHexDigits[b >> 4]);
+        txStageByte(at++, txHexDigits[b & 0x0F]);
+    }
+    return at;
+}
\ No newline at end of file
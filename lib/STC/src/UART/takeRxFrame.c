@@ -0,0 +1,10 @@
+#include "STC/UART/RxFrame.h"
+
+uint8_t takeRxFrame(uint8_t* frame, uint8_t maxLen)
+{
+    uint8_t len = 0;
+    while (rxHead != rxFrameEnd && len < maxLen)
+        frame[len++] = rxRing[rxHead++ & (RxRingSize - 1)];
+    if ((rxPauseReasons & RxPauseFull) && (uint8_t)(rxTail - rxHead) <= RxLowWater) resumeRx(RxPauseFull);
+    return len;
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#include "STC/UART/TxQueue.h"
+
+uint8_t txCommitStaged(uint8_t len)
+{
+    __xdata TxDesc_t* last;
+    uint8_t           queued  = 1;
+    uint8_t           enabled = maskInterrupt(TxInterrupts);
+
+    last = &txDescs[(txDescTail - 1) & (TxDescCount - 1)];
+    if (txDescHead != txDescTail && last->src == TxFromRing) {
+        // Extend the last descriptor as it takes from the ring too
+        txRingTail += len;
+        last->len += len;
+        kickTx();
+    }
+    else if (pushTxDesc(TxFromRing, 0, len)) {
+        txRingTail += len;
+        commitTxDesc();
+    }
+    else
+        queued = 0;
+    unmaskInterrupt(enabled);
+    return queued;
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#include "STC/UART/TxQueue.h"
+
+uint8_t txPutByte(uint8_t b)
+{
+    uint8_t queued  = 0;
+    uint8_t enabled = maskInterrupt(TxInterrupts);
+
+    if (txRingFree()) {
+        txStageByte(0, b);
+        queued = txCommitStaged(1);
+    }
+    unmaskInterrupt(enabled);
+    return queued;
+}
\ No newline at end of file
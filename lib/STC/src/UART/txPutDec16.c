@@ -0,0 +1,7 @@
+#include "STC/UART/TxFormat.h"
+
+uint8_t txPutDec16(uint16_t value)
+{
+    if (txRingFree() < TxDec16Digits) return 0;
+    return txCommitStaged(stageDec16(value, 0, 0, 0));
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#include "STC/UART/TxFormat.h"
+
+uint8_t txPutDec32(uint32_t value)
+{
+    uint32_t power;
+    uint8_t  i, digit, at = 0;
+
+    if (txRingFree() < TxDec32Digits) return 0;
+    if (!(value >> 16)) return txCommitStaged(stageDec16(value, 0, 0, 0));
+
+    for (i = 0; i < 6; i++) {
+        power = txDecPowers32[i];
+        digit = 0;
+        while (value >= power) {
+            value -= power;
+            digit++;
+        }
+        if (digit || at) txStageByte(at++, '0' + digit);
+    }
+    // The rest is below 10000, the leading digits are staged as value was at least 65536
+    return txCommitStaged(stageDec16(value, at, 1, 1));
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "STC/UART/TxFormat.h"
+
+uint8_t txPutDec8(uint8_t value)
+{
+    if (txRingFree() < TxDec8Digits) return 0;
+    return txCommitStaged(stageDec16(value, 0, 2, 0));
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#include "STC/UART/TxQueue.h"
+
+uint8_t txPutHeader(const uint8_t* header, uint8_t len, uint8_t bodyDescs)
+{
+    uint8_t i;
+
+    if (txDescFree() < bodyDescs + 1 || txRingFree() < len) return 0;
+    for (i = 0; i < len; i++)
+        txStageByte(i, header[i]);
+    return txCommitStaged(len);
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "STC/UART/TxFormat.h"
+
+uint8_t txPutHex16(uint16_t value)
+{
+    if (txRingFree() < 4) return 0;
+    return txCommitStaged(stageHex((const uint8_t*)&value, 2));
+}
\ No newline at end of file
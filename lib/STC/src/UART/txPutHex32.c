@@ -0,0 +1,7 @@
+#include "STC/UART/TxFormat.h"
+
+uint8_t txPutHex32(uint32_t value)
+{
+    if (txRingFree() < 8) return 0;
+    return txCommitStaged(stageHex((const uint8_t*)&value, 4));
+}
\ No newline at end of file
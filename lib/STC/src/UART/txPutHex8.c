@@ -0,0 +1,7 @@
+#include "STC/UART/TxFormat.h"
+
+uint8_t txPutHex8(uint8_t value)
+{
+    if (txRingFree() < 2) return 0;
+    return txCommitStaged(stageHex(&value, 1));
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#include "STC/UART/TxQueue.h"
+
+uint8_t txPutIAP(uint16_t addr, uint16_t len, uint8_t flags)
+{
+    __xdata TxDesc_t* desc;
+    uint8_t           enabled = maskInterrupt(TxInterrupts);
+
+    desc = pushTxDesc(TxFromIAP, flags, len);
+    if (desc) {
+        desc->at.iap = addr;
+        commitTxDesc();
+    }
+    unmaskInterrupt(enabled);
+    return desc != 0;
+}
\ No newline at end of file
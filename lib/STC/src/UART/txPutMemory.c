@@ -0,0 +1,15 @@
+#include "STC/UART/TxQueue.h"
+
+uint8_t txPutMemory(const char* mem, uint16_t len, uint8_t flags)
+{
+    __xdata TxDesc_t* desc;
+    uint8_t           enabled = maskInterrupt(TxInterrupts);
+
+    desc = pushTxDesc(TxFromMemory, flags, len);
+    if (desc) {
+        desc->at.mem = mem;
+        commitTxDesc();
+    }
+    unmaskInterrupt(enabled);
+    return desc != 0;
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+#pragma nooverlay
+#include "STC/UART/TxQueue.h"
+
+void txPutUrgent(uint8_t b)
+{
+    txUrgentByte = b;
+    txUrgent     = 1;
+    kickTx();
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#include "STC/UART/Autobaud.h"
+
+uint8_t waitAutobaudRxd(uint8_t level, uint8_t limit)
+{
+    while (AutobaudRxd != level) {
+        if (TF1) {
+            TF1 = 0;
+            if (++autobaudOverflows == limit) return 0;
+        }
+    }
+    return 1;
+}
\ No newline at end of file
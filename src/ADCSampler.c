@@ -0,0 +1,137 @@
+#pragma nooverlay
+#include "ADCSampler.h"
+
+__code ADCChannel_t samplerChannels[SamplerChannelCount] = {SupplyADCChannel, AntennaADCChannel};
+__xdata uint16_t    sampleRing[SampleRingSize];
+uint8_t             sampleHead, sampleTail;
+uint8_t             samplesDropped;
+uint16_t            samplerSums[SamplerChannelCount];
+uint16_t            samplerLevels[SamplerChannelCount];
+uint8_t             samplerChannel;
+uint8_t             samplerRound;
+uint8_t             samplerRunning;
+uint8_t             samplerStreaming;
+uint8_t             samplerOneShot;
+uint8_t             samplerFresh;
+
+void initSampler()
+{
+    uint8_t  i, inputs = 0;
+    ADCCfg_t cfg;
+
+    for (i = 0; i < SamplerChannelCount; i++)
+        inputs |= 1 << samplerChannels[i];
+    cfg.speed  = SamplerSpeed;
+    cfg.inputs = inputs;
+    cfg.it     = EnableIT;
+    configureADC(&cfg);
+}
+
+void startSampler()
+{
+    uint8_t i;
+
+    if (samplerRunning) return;
+    for (i = 0; i < SamplerChannelCount; i++)
+        samplerSums[i] = 0;
+    samplerChannel = 0;
+    samplerRound   = 0;
+    samplerRunning = 1;
+    startADC(samplerChannels[0]);
+}
+
+void pushSampleFrame()
+{
+    uint8_t i;
+    // Frames taken only for the levels are not streamed
+    uint8_t push = samplerStreaming;
+    uint8_t room = SampleRingSize - (uint8_t)(sampleTail - sampleHead) >= SamplerChannelCount;
+
+    for (i = 0; i < SamplerChannelCount; i++) {
+        samplerLevels[i] = samplerSums[i] >> SamplerOversampleBits;
+        samplerSums[i]   = 0;
+        if (push && room) sampleRing[sampleTail++ & (SampleRingSize - 1)] = samplerLevels[i];
+    }
+    if (push && !room) samplesDropped++;
+    if (samplerOneShot) {
+        samplerOneShot = 0;
+        samplerFresh   = 1;
+        if (!samplerStreaming) samplerRunning = 0;
+    }
+}
+
+void onADCDone()
+{
+    samplerSums[samplerChannel] += readADC();
+    if (++samplerChannel == SamplerChannelCount) {
+        samplerChannel = 0;
+        if (++samplerRound == SamplerOversample) {
+            samplerRound = 0;
+            pushSampleFrame();
+        }
+    }
+    if (samplerRunning)
+        startADC(samplerChannels[samplerChannel]);
+    else
+        clearADCFlag();
+}
+
+uint16_t readSamplerLevel(uint8_t index)
+{
+    uint8_t  enabled = maskInterrupt(InterruptADC);
+    uint16_t level   = samplerLevels[index];
+    unmaskInterrupt(enabled);
+    return level;
+}
+
+uint8_t refreshSamplerLevels()
+{
+    if (samplerStreaming) return 1;
+    if (samplerFresh) {
+        samplerFresh = 0;
+        return 1;
+    }
+    // Started again if the end of a stream stopped it meanwhile
+    if (!samplerRunning) {
+        startSampler();
+        samplerOneShot = 1;
+    }
+    return 0;
+}
+
+uint8_t toggleSampleStream()
+{
+    if (samplerStreaming) {
+        samplerStreaming = 0;
+        stopSampler();
+        return 1;
+    }
+    if (txRingFree() < SamplerHeaderSize) return 0;
+    txStageByte(0, SamplerStreamMagic);
+    txStageByte(1, SamplerChannelCount);
+    txStageByte(2, SamplerOversampleBits);
+    if (!txCommitStaged(SamplerHeaderSize)) return 0;
+    // Samples older than the stream are not sent
+    sampleHead       = sampleTail;
+    samplerStreaming = 1;
+    startSampler();
+    return 1;
+}
+
+void pumpSamples()
+{
+    uint8_t  i, low = 0;
+    uint16_t sample;
+
+    if (!samplerStreaming) return;
+    if ((uint8_t)(sampleTail - sampleHead) < SamplesPerGroup) return;
+    // A group is never split, or the host loses sync
+    if (txRingFree() < SampleGroupSize || !txDescFree()) return;
+
+    for (i = 0; i < SamplesPerGroup; i++) {
+        sample = sampleRing[sampleHead++ & (SampleRingSize - 1)];
+        txPutByte(sample >> 2);
+        low |= (sample & 0x03) << (i * 2);
+    }
+    txPutByte(low);
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "AlphaSender.h"
+
+const __code char lowerAlphabet[AlphabetLen + 1] = "abcdefghijklmnopqrstuvwxyz";
+const __code char upperAlphabet[AlphabetLen + 1] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+const __code char newLine[2]                     = "\n";
+
+__xdata uint8_t savedData[AlphabetLen];
+
+void saveSentData(const uint8_t* record, uint8_t size)
+{
+    cacheRecord(record, size);
+    appendHistory(record, size);
+}
+
+void sendSavedData()
+{
+    uint8_t first, count, len;
+    int8_t  delta;
+
+    // Nothing saved
+    if (!readNewestEntry()) return;
+    // A response saved by sendAlpha(), streamed by the TI isr from the alphabet in code memory
+    if (decodeRun(recordLogEntry, &first, &delta, &count) && (delta == 1 || !count) && count < AlphabetLen &&
+        (first == 'a' || first == 'A')) {
+        txPutMemory(first == 'a' ? lowerAlphabet : upperAlphabet, count + 1, 0);
+    }
+    else {
+        len = decodeRecord(recordLogEntry, savedData, sizeof(savedData));
+        if (!len) return;
+        txPutMemory((const char*)savedData, len, 0);
+    }
+    txPutMemory(newLine, 1, 0);
+}
+
+void sendAlpha(char endChar)
+{
+    const char* alphabet;
+    uint8_t     len, size;
+    uint8_t     record[RecordRunSize];
+    if (endChar <= 'z' && endChar >= 'a')
+        alphabet = lowerAlphabet;
+    else if (endChar <= 'Z' && endChar >= 'A')
+        alphabet = upperAlphabet;
+    else
+        return;
+
+    // Streamed by the TI isr straight from code memory
+    len = endChar - alphabet[0] + 1;
+    txPutMemory(alphabet, len, 0);
+    txPutMemory(newLine, 1, 0);
+
+    // The response is a run of +1 from its first char
+    size = encodeRun(record, alphabet[0], 1, len - 1);
+    saveSentData(record, size);
+}
\ No newline at end of file
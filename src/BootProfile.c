@@ -0,0 +1,14 @@
+#include "BootProfile.h"
+
+__xdata uint16_t bootProfile[BootPhaseCount];
+
+uint8_t dumpBootProfile()
+{
+    uint8_t header[BootProfileHeaderSize];
+
+    header[0] = BootProfileMagic;
+    header[1] = BootPhaseCount;
+    if (!txPutHeader(header, BootProfileHeaderSize, 1)) return 0;
+    txPutMemory((const char*)bootProfile, sizeof(bootProfile), 0);
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma nooverlay
+#include "BusNode.h"
+
+#if AddressedBusMode
+uint8_t nodeAddr;
+
+void initBusNode()
+{
+    if (!getConfig(KeyNodeAddr, &nodeAddr, 1)) nodeAddr = DefaultNodeAddr;
+    SADDR = nodeAddr;
+    // Compare every bit, SADDR | SADEN = 0xFF is the broadcast address
+    SADEN = 0xFF;
+    // Reply in data frames
+    TB8 = 0;
+}
+
+void setNodeAddr(uint8_t addr)
+{
+    if (addr == BusBroadcastAddr) return;
+    setConfig(KeyNodeAddr, &addr, 1);
+    nodeAddr = addr;
+    SADDR    = addr;
+}
+
+uint8_t acceptBusFrame(uint8_t data)
+{
+    if (RB8) {
+        // Listen to data frames only if this node is selected
+        SM2 = !(data == nodeAddr || data == BusBroadcastAddr);
+        return 0;
+    }
+    return !SM2;
+}
+#endif
\ No newline at end of file
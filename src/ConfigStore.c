@@ -0,0 +1,133 @@
+#include "ConfigStore.h"
+
+__xdata uint16_t configIndex[ConfigKeyCount];
+uint16_t         configSector;
+uint16_t         configFree;
+uint8_t          configGen;
+
+void indexConfigSector()
+{
+    uint16_t off = 1;
+    uint8_t  key, len, i;
+
+    for (i = 0; i < ConfigKeyCount; i++)
+        configIndex[i] = 0;
+
+    while (off + 3 <= IAPSectorSize) {
+        key = readIAPAt(configSector + off);
+        if (key == 0xFF) break;
+        len = readIAPAt(configSector + off + 1);
+        // Power lost while appending, make the next write compact the sector
+        if (len > ConfigMaxValueSize || off + 3 + len > IAPSectorSize) {
+            off = IAPSectorSize;
+            break;
+        }
+        if (key < ConfigKeyCount && readIAPAt(configSector + off + 2 + len) == ConfigCommitMark)
+            configIndex[key] = off;
+        off += 3 + len;
+    }
+    configFree = off;
+}
+
+void initConfigStore()
+{
+    uint8_t genA, genB;
+
+    holdIAP();
+    genA = readIAPAt(ConfigSectorA);
+    genB = readIAPAt(ConfigSectorB);
+    if (genA == 0xFF && genB == 0xFF) {
+        // Nothing stored yet
+        configSector = ConfigSectorA;
+        configGen    = 0;
+        eraseSector(ConfigSectorA);
+        writeIAPAt(ConfigSectorA, configGen);
+    }
+    else if (genB == 0xFF || (genA != 0xFF && (int8_t)(genA - genB) > 0)) {
+        configSector = ConfigSectorA;
+        configGen    = genA;
+    }
+    else {
+        configSector = ConfigSectorB;
+        configGen    = genB;
+    }
+    indexConfigSector();
+    releaseIAP();
+}
+
+uint8_t getConfig(ConfigKey_t key, uint8_t* value, uint8_t maxLen)
+{
+    uint16_t addr;
+    uint8_t  len, i;
+
+    if (key >= ConfigKeyCount || !configIndex[key]) return 0;
+
+    holdIAP();
+    addr = configSector + configIndex[key];
+    len  = readIAPAt(addr + 1);
+    if (len > maxLen) len = maxLen;
+    writeIAPAddr(addr + 2);
+    for (i = 0; i < len; i++) {
+        value[i] = readFromIAP();
+        incIAPAddr();
+    }
+    releaseIAP();
+    return len;
+}
+
+void copyIAP(uint16_t from, uint16_t to, uint8_t len)
+{
+    while (len--)
+        writeIAPAt(to++, readIAPAt(from++));
+}
+
+void compactConfigStore()
+{
+    uint16_t spare = configSector == ConfigSectorA ? ConfigSectorB : ConfigSectorA;
+    uint16_t off   = 1;
+    uint16_t entry;
+    uint8_t  i, len;
+
+    eraseSector(spare);
+    for (i = 0; i < ConfigKeyCount; i++) {
+        if (!configIndex[i]) continue;
+        entry = configSector + configIndex[i];
+        len   = readIAPAt(entry + 1) + 3;
+        copyIAP(entry, spare + off, len);
+        configIndex[i] = off;
+        off += len;
+    }
+    // The spare sector is valid after its generation is written
+    configGen = NextConfigGen(configGen);
+    writeIAPAt(spare, configGen);
+    configSector = spare;
+    configFree   = off;
+}
+
+uint8_t setConfig(ConfigKey_t key, const uint8_t* value, uint8_t len)
+{
+    uint16_t addr;
+    uint8_t  i;
+
+    if (key >= ConfigKeyCount || len > ConfigMaxValueSize) return 0;
+
+    holdIAP();
+    if (configFree + 3 + len > IAPSectorSize) compactConfigStore();
+    // Still full with the newest entry of every key
+    if (configFree + 3 + len > IAPSectorSize) {
+        releaseIAP();
+        return 0;
+    }
+
+    addr = configSector + configFree;
+    writeIAPAt(addr, key);
+    writeIAPAt(addr + 1, len);
+    for (i = 0; i < len; i++)
+        writeIAPAt(addr + 2 + i, value[i]);
+    writeIAPAt(addr + 2 + len, ConfigCommitMark);
+
+    configIndex[key] = configFree;
+    configFree += 3 + len;
+    releaseIAP();
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+#pragma nooverlay
+#include "EEPROMCommitter.h"
+
+__xdata CommitSlot_t commitSlots[CommitQueueSize];
+CommitState_t        commitState;
+uint8_t              commitSlot;
+uint8_t              commitOffset;
+uint8_t              iapHeld;
+uint8_t              commitUrgent;
+uint8_t              commitRushed;
+uint8_t              commitPausing;
+CommitUrgeHook_t     commitUrgeHook;
+ErasePauseHook_t     erasePauseHook;
+EraseResumeHook_t    eraseResumeHook;
+
+void initCommitter()
+{
+    uint8_t i;
+    for (i = 0; i < CommitQueueSize; i++)
+        commitSlots[i].pending = 0;
+    commitState   = CommitIdle;
+    commitPausing = 0;
+}
+
+int isCommitIdle()
+{
+    uint8_t i;
+    if (commitState != CommitIdle) return 0;
+    for (i = 0; i < CommitQueueSize; i++)
+        if (commitSlots[i].pending) return 0;
+    return 1;
+}
+
+uint8_t requestCommit(uint16_t addr, const uint8_t* data, uint8_t len, uint8_t erase, CommitCallback_t onDone)
+{
+    __xdata CommitSlot_t* slot = 0;
+    CriticalState_t       state;
+    uint8_t               i;
+
+    if (len > CommitRecordSize) return 0;
+
+    state = enterCritical();
+    // Coalesce with the record already queued
+    for (i = 0; i < CommitQueueSize; i++) {
+        if ((commitSlots[i].pending || isCommitActive(i)) && commitSlots[i].addr == addr) {
+            slot = &commitSlots[i];
+            break;
+        }
+    }
+    if (!slot) {
+        for (i = 0; i < CommitQueueSize; i++) {
+            if (!commitSlots[i].pending && !isCommitActive(i)) {
+                slot = &commitSlots[i];
+                break;
+            }
+        }
+    }
+    if (slot) {
+        slot->addr   = addr;
+        slot->len    = len;
+        slot->erase  = erase;
+        slot->onDone = onDone;
+        for (i = 0; i < len; i++)
+            slot->data[i] = data[i];
+        slot->pending = 1;
+    }
+    exitCritical(state);
+    return slot != 0;
+}
+
+void eraseSector(uint16_t addr)
+{
+    uint8_t first = 1;
+
+    if (erasePauseHook) {
+        while (!erasePauseHook(first))
+            first = 0;
+    }
+    writeIAPAddr(addr);
+    doIAPOp(Erase);
+    if (eraseResumeHook) eraseResumeHook();
+}
+
+void doCommitStep()
+{
+    __xdata CommitSlot_t* slot = &commitSlots[commitSlot];
+    CriticalState_t       state;
+    uint8_t               i, ready;
+
+    switch (commitState) {
+        case CommitIdle:
+            state = enterCritical();
+            for (i = 0; i < CommitQueueSize; i++) {
+                if (commitSlots[i].pending) {
+                    commitSlots[i].pending = 0;
+                    commitSlot             = i;
+                    commitState            = CommitPause;
+                    break;
+                }
+            }
+            exitCritical(state);
+            break;
+        case CommitPause:
+            if (slot->erase && erasePauseHook) {
+                ready         = erasePauseHook(!commitPausing);
+                commitPausing = 1;
+                if (!ready && !commitRushed) break;
+            }
+            commitState = CommitErase;
+            break;
+        case CommitErase:
+            if (slot->erase) {
+                writeIAPAddr(slot->addr);
+                doIAPOp(Erase);
+                if (commitPausing) {
+                    commitPausing = 0;
+                    eraseResumeHook();
+                }
+            }
+            commitOffset = 0;
+            commitState  = CommitProgram;
+            break;
+        case CommitProgram:
+            // Newer payload arrived, start over
+            if (slot->pending) {
+                slot->pending = 0;
+                commitState   = CommitPause;
+                break;
+            }
+            if (commitOffset == slot->len) {
+                commitState = CommitIdle;
+                if (slot->onDone) slot->onDone(slot->addr);
+                break;
+            }
+            // Programming 0xFF leaves the byte as is, e.g. the padding of a history entry
+            if (slot->data[commitOffset] != 0xFF) {
+                writeIAPAddr(slot->addr + commitOffset);
+                writeToIAP(slot->data[commitOffset]);
+            }
+            commitOffset++;
+            break;
+    }
+}
+
+void commitUrgently()
+{
+    commitRushed = 1;
+    do {
+        while (!isCommitIdle())
+            doCommitStep();
+        if (commitUrgeHook) commitUrgeHook();
+    } while (!isCommitIdle());
+    commitRushed = 0;
+}
+
+void releaseIAP()
+{
+    CriticalState_t state;
+
+    for (;;) {
+        // An urge between the check and the release would be lost
+        state = enterCritical();
+        if (!commitUrgent) {
+            iapHeld = 0;
+            exitCritical(state);
+            return;
+        }
+        commitUrgent = 0;
+        exitCritical(state);
+        commitUrgently();
+    }
+}
+
+void stepCommit()
+{
+    holdIAP();
+    doCommitStep();
+    releaseIAP();
+}
+
+void urgeCommit()
+{
+    commitUrgent = 1;
+    if (iapHeld) return;
+    commitUrgent = 0;
+    commitUrgently();
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma nooverlay
+#include "LedBlinker.h"
+
+const __code LedStep_t blinkRoutine[BlinkRoutineLen] = {{1, MsToPCATicks(1000)}, {0, MsToPCATicks(1000)}};
+
+const __code LedStep_t* ledRoutine;
+uint8_t                 ledRoutineLen;
+uint8_t                 ledStep;
+uint32_t                ledRemainTicks;
+uint16_t                ledCompare;
+
+void onLedMatch()
+{
+    uint16_t chunk;
+
+    if (!ledRemainTicks) {
+        Led            = !ledRoutine[ledStep].on;
+        ledRemainTicks = ledRoutine[ledStep].ticks;
+        if (++ledStep == ledRoutineLen) ledStep = 0;
+    }
+    chunk = ledRemainTicks > LedMaxChunkTicks ? LedMaxChunkTicks : ledRemainTicks;
+    ledRemainTicks -= chunk;
+    ledCompare += chunk;
+    setPCACompare(LedModule, ledCompare);
+}
+
+void playLedRoutine(const __code LedStep_t* routine, uint8_t len)
+{
+    CriticalState_t state = enterCritical();
+    ledRoutine     = routine;
+    ledRoutineLen  = len;
+    ledStep        = 0;
+    ledRemainTicks = 0;
+    ledCompare     = readPCACounter();
+    configurePCAModule(LedModule, PCASoftTimer, EnableIT);
+    onLedMatch();
+    exitCritical(state);
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma nooverlay
+#include "NorFlash.h"
+#include "RecordStore.h"
+
+#if RecordStoreOnNor
+uint8_t norPresent;
+
+void sendNorCommand(uint8_t cmd, uint32_t addr)
+{
+    selectNor();
+    transferSPI(cmd);
+    transferSPI(addr >> 16);
+    transferSPI(addr >> 8);
+    transferSPI(addr);
+}
+
+uint8_t isNorBusy()
+{
+    uint8_t status;
+    selectNor();
+    transferSPI(NorCmdReadStatus);
+    status = transferSPI(0xFF);
+    deselectNor();
+    return status & NorStatusBusy;
+}
+
+void enableNorWrite()
+{
+    selectNor();
+    transferSPI(NorCmdWriteEnable);
+    deselectNor();
+}
+
+uint8_t initNorFlash()
+{
+    SPICfg_t cfg = {.clock = NorSPIClock, .mode = SPIMode0, .lsbFirst = 0};
+    uint8_t  maker;
+
+    // Chip select as push-pull, deselected
+    deselectNor();
+    P1M1 &= 0xEF;
+    P1M0 |= 0x10;
+    configureSPI(&cfg);
+
+    selectNor();
+    transferSPI(NorCmdJedecId);
+    maker = transferSPI(0xFF);
+    deselectNor();
+    norPresent = maker != 0x00 && maker != 0xFF;
+    return norPresent;
+}
+
+void readNor(uint32_t addr, uint8_t* out, uint16_t len)
+{
+    sendNorCommand(NorCmdRead, addr);
+    while (len--)
+        *out++ = transferSPI(0xFF);
+    deselectNor();
+}
+
+uint8_t readNorByte(uint32_t addr)
+{
+    uint8_t b;
+    readNor(addr, &b, 1);
+    return b;
+}
+
+void eraseNorSector(uint32_t addr)
+{
+    enableNorWrite();
+    sendNorCommand(NorCmdSectorErase, addr);
+    deselectNor();
+}
+
+void onNorPayloadSent()
+{
+    deselectNor();
+}
+
+void programNorPage(uint32_t addr, const uint8_t* data, uint16_t len)
+{
+    enableNorWrite();
+    sendNorCommand(NorCmdPageProgram, addr);
+    startSPITransfer(data, 0, len, onNorPayloadSent);
+}
+
+void writeNorPage(uint32_t addr, const uint8_t* data, uint16_t len)
+{
+    enableNorWrite();
+    sendNorCommand(NorCmdPageProgram, addr);
+    while (len--)
+        transferSPI(*data++);
+    deselectNor();
+    while (isNorBusy())
+        ;
+}
+#endif
\ No newline at end of file
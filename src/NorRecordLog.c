@@ -0,0 +1,194 @@
+#pragma nooverlay
+#include "RecordStore.h"
+
+#if RecordStoreOnNor
+__xdata NorBatch_t norBatches[2];
+uint8_t            norFilling;
+uint8_t            norProgOff;
+uint32_t           recordLogFree;
+uint32_t           recordLogNewest;
+uint32_t           norEraseAddr;
+__xdata uint8_t    recordLogEntry[CommitRecordSize];
+
+uint8_t readRecordLogEntry(uint32_t addr, uint8_t* out)
+{
+    __xdata NorBatch_t* batch;
+    uint16_t            size;
+    uint8_t             i, b;
+
+    for (b = 0; b < 2; b++) {
+        batch = &norBatches[b];
+        if (batch->len && addr >= batch->addr && addr < batch->addr + batch->len) {
+            size = encodedRecordSize(batch->data + (uint8_t)(addr - batch->addr));
+            for (i = 0; i < size; i++)
+                out[i] = batch->data[(uint8_t)(addr - batch->addr) + i];
+            return size;
+        }
+    }
+
+    readNor(addr, out, 2);
+    size = encodedRecordSize(out);
+    if (!size || size > RecordLogMaxSize || (addr & (NorSectorSize - 1)) + size >= NorSectorSize) return 0;
+    readNor(addr, out, size);
+    return size;
+}
+
+void initRecordLog()
+{
+    uint32_t sector = NorLogAddr, next, addr;
+    uint8_t  i, size;
+
+    recordLogNewest   = RecordLogNone;
+    norEraseAddr      = RecordLogNone;
+    recordLogFree     = NorLogAddr;
+    norBatches[0].len = 0;
+    norBatches[1].len = 0;
+    norFilling        = 0;
+    if (!initNorFlash()) return;
+
+    for (i = 0; i < NorLogSectorCount; i++) {
+        next = NextNorLogSector(sector);
+        if (readNorByte(sector) != 0xFF && readNorByte(next) == 0xFF) break;
+        sector = next;
+    }
+    if (i == NorLogSectorCount) {
+        // Empty, or no erased sector is left by a lost erase
+        if (readNorByte(NorLogAddr) == 0xFF) return;
+        eraseNorSector(NorLogAddr);
+        while (isNorBusy())
+            ;
+        eraseNorSector(NextNorLogSector(NorLogAddr));
+        while (isNorBusy())
+            ;
+        return;
+    }
+
+    addr = sector;
+    while (addr < sector + NorSectorSize && readNorByte(addr) != 0xFF) {
+        size = readRecordLogEntry(addr, recordLogEntry);
+        // Broken header, make the next append enter the next sector
+        if (!size) {
+            addr = sector + NorSectorSize;
+            break;
+        }
+        if (readNorByte(addr + size) == RecordLogMark) recordLogNewest = addr;
+        addr += size + 1;
+    }
+    recordLogFree = addr;
+}
+
+uint8_t appendRecordLog(const uint8_t* record, uint8_t size)
+{
+    __xdata NorBatch_t* batch;
+    uint32_t            addr;
+    CriticalState_t     state;
+    uint8_t             entering, queued = 0, i;
+
+    if (!norPresent || size > RecordLogMaxSize) return 0;
+
+    state = enterCritical();
+    addr = recordLogFree;
+    // Entries never cross a sector, so an erase only drops whole entries
+    if ((addr & (NorSectorSize - 1)) + size + 1 > NorSectorSize)
+        addr = NextNorLogSector(addr);
+    else
+        addr = NorLogAddr + ((addr - NorLogAddr) & (NorLogSize - 1));
+    entering = !(addr & (NorSectorSize - 1));
+
+    batch = &norBatches[norFilling];
+    // Entering a sector waits for the last erase, the batch only takes contiguous entries
+    if ((!entering || norEraseAddr == RecordLogNone) &&
+        (!batch->len || (batch->addr + batch->len == addr && batch->len + size + 1 <= NorBatchSize))) {
+        if (!batch->len) batch->addr = addr;
+        for (i = 0; i < size; i++)
+            batch->data[batch->len + i] = record[i];
+        batch->data[batch->len + size] = RecordLogMark;
+        batch->len += size + 1;
+
+        // Keep the sector after the one in use erased
+        if (entering) norEraseAddr = NextNorLogSector(addr);
+        recordLogNewest = addr;
+        recordLogFree   = addr + size + 1;
+        queued          = 1;
+    }
+    exitCritical(state);
+    return queued;
+}
+
+void stepRecordLog()
+{
+    __xdata NorBatch_t* batch;
+    uint16_t            pageLeft;
+    uint8_t             len;
+
+    if (!norPresent || spiBusy || isNorBusy()) return;
+    if (norEraseAddr != RecordLogNone) {
+        eraseNorSector(norEraseAddr);
+        norEraseAddr = RecordLogNone;
+        return;
+    }
+
+    batch = &norBatches[!norFilling];
+    if (!batch->len) {
+        // Program the batch filled meanwhile, the other one fills up next
+        CriticalState_t state = enterCritical();
+        if (norBatches[norFilling].len) norFilling = !norFilling;
+        exitCritical(state);
+        batch = &norBatches[!norFilling];
+        if (!batch->len) return;
+        norProgOff = 0;
+    }
+
+    // A page program wraps at the end of the page, split it there
+    len      = batch->len - norProgOff;
+    pageLeft = NorPageSize - ((batch->addr + norProgOff) & (NorPageSize - 1));
+    if (len > pageLeft) len = pageLeft;
+    programNorPage(batch->addr + norProgOff, batch->data + norProgOff, len);
+    norProgOff += len;
+    // Stays unchanged until the transfer is done, the batch only refills after a swap
+    if (norProgOff == batch->len) batch->len = 0;
+}
+
+uint8_t readNewestEntry()
+{
+    CriticalState_t state;
+    uint8_t         size;
+
+    if (recordLogNewest == RecordLogNone) return 0;
+    while (spiBusy || isNorBusy())
+        ;
+    state = enterCritical();
+    size  = readRecordLogEntry(recordLogNewest, recordLogEntry);
+    exitCritical(state);
+    return size;
+}
+
+uint8_t readNewestRecord(uint8_t* out, uint8_t maxLen)
+{
+    if (!readNewestEntry()) return 0;
+    return decodeRecord(recordLogEntry, out, maxLen);
+}
+
+void urgeRecordLog()
+{
+    __xdata NorBatch_t* batch;
+    uint16_t            pageLeft;
+    uint8_t             i, off, len;
+
+    if (!norPresent || spiBusy || !FlashCs) return;
+    while (isNorBusy())
+        ;
+    for (i = 0; i < 2; i++) {
+        batch = &norBatches[i == 0 ? !norFilling : norFilling];
+        off   = i == 0 ? norProgOff : 0;
+        while (off < batch->len) {
+            len      = batch->len - off;
+            pageLeft = NorPageSize - ((batch->addr + off) & (NorPageSize - 1));
+            if (len > pageLeft) len = pageLeft;
+            writeNorPage(batch->addr + off, batch->data + off, len);
+            off += len;
+        }
+        batch->len = 0;
+    }
+}
+#endif
\ No newline at end of file
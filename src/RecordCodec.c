@@ -0,0 +1,44 @@
+#include "RecordCodec.h"
+
+uint8_t getVarint(const uint8_t* in, uint16_t* value)
+{
+    uint8_t len = 0, shift = 0;
+    *value = 0;
+    do {
+        // Still continued after the last byte, a torn or foreign header
+        if (len == RecordVarintMaxLen) return 0;
+        *value |= (uint16_t)(in[len] & 0x7F) << shift;
+        shift += 7;
+    } while (in[len++] & 0x80);
+    return len;
+}
+
+uint8_t decodeRecord(const uint8_t* in, uint8_t* out, uint8_t maxLen)
+{
+    uint16_t header;
+    uint8_t  i   = getVarint(in, &header);
+    uint8_t  end = i + (header >> 1);
+    uint8_t  len = 0, count, prev;
+    int8_t   delta;
+
+    if (!i) return 0;
+
+    if (!(header & RecordDeltaRuns)) {
+        while (i < end && len < maxLen)
+            out[len++] = in[i++];
+        return len;
+    }
+
+    if (i == end || !maxLen) return 0;
+    prev       = in[i++];
+    out[len++] = prev;
+    while (i + 1 < end) {
+        delta = in[i++];
+        count = in[i++];
+        while (count-- && len < maxLen) {
+            prev += delta;
+            out[len++] = prev;
+        }
+    }
+    return len;
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma nooverlay
+#include "RecordHistory.h"
+
+uint8_t         historyHead;
+uint8_t         historyCount;
+uint16_t        historySeq;
+__xdata uint8_t historyEntry[HistoryEntrySize];
+uint8_t         historyStaged;
+uint8_t         historyBusy;
+uint8_t         historyDumping;
+uint8_t         historyDumpDesc;
+
+uint16_t readHistorySeq(uint8_t entry)
+{
+    uint16_t addr = HistoryEntryAddr(entry) + HistorySeqOffset;
+    return readIAPAt(addr) | (uint16_t)readIAPAt(addr + 1) << 8;
+}
+
+void initHistory()
+{
+    uint16_t seq, newest = 0;
+    uint8_t  i, found = 0;
+
+    holdIAP();
+    historyCount   = 0;
+    historyStaged  = 0;
+    historyBusy    = 0;
+    historyDumping = 0;
+    for (i = 0; i < HistoryEntryCount; i++) {
+        seq = readHistorySeq(i);
+        if (seq == 0xFFFF) continue;
+        historyCount++;
+        if (!found || (int16_t)(seq - newest) > 0) {
+            newest      = seq;
+            historyHead = i;
+            found       = 1;
+        }
+    }
+    if (found) {
+        historySeq  = newest + 1;
+        historyHead = (historyHead + 1) % HistoryEntryCount;
+        // Power lost while appending, skip the torn entry, len is programmed first and never 0xFF
+        if (historyHead % HistoryEntriesPerSector && readIAPAt(HistoryEntryAddr(historyHead)) != 0xFF) {
+            historyHead = (historyHead + 1) % HistoryEntryCount;
+            // Keep the dumped range contiguous, the torn entry is sent as empty
+            if (historyCount < HistoryEntryCount) historyCount++;
+        }
+    }
+    else {
+        historySeq  = 0;
+        historyHead = 0;
+    }
+    releaseIAP();
+}
+
+void appendHistory(const uint8_t* data, uint8_t len)
+{
+    uint32_t tick = getSysTickMs();
+    uint8_t  i;
+
+    if (len > HistoryMaxPayloadSize) len = HistoryMaxPayloadSize;
+
+    historyEntry[0] = len;
+    for (i = 0; i < 4; i++)
+        historyEntry[1 + i] = tick >> (i * 8);
+    for (i = 0; i < HistorySeqOffset - HistoryHeaderSize; i++)
+        historyEntry[HistoryHeaderSize + i] = i < len ? data[i] : 0xFF;
+    historyStaged = 1;
+}
+
+void onHistoryCommitted(uint16_t addr)
+{
+    historyHead = (historyHead + 1) % HistoryEntryCount;
+    if (historyCount < HistoryEntryCount) historyCount++;
+    historyBusy = 0;
+}
+
+void stepHistory()
+{
+    uint8_t erase = !(historyHead % HistoryEntriesPerSector);
+
+    if (historyDumping) {
+        if (!isTxDescSent(historyDumpDesc)) return;
+        historyDumping = 0;
+    }
+    if (!historyStaged || historyBusy) return;
+
+    historyEntry[HistorySeqOffset]     = historySeq;
+    historyEntry[HistorySeqOffset + 1] = historySeq >> 8;
+    if (!requestCommit(HistoryEntryAddr(historyHead), historyEntry, HistoryEntrySize, erase, onHistoryCommitted))
+        return;
+    historyStaged = 0;
+    historyBusy   = 1;
+    historySeq++;
+    // Entries of the sector are dropped, leave them out of dumps from now on
+    if (erase && historyCount > HistoryEntryCount - HistoryEntriesPerSector)
+        historyCount = HistoryEntryCount - HistoryEntriesPerSector;
+}
+
+uint8_t dumpHistory()
+{
+    CriticalState_t state;
+    uint8_t         head, count, oldest, first;
+    uint8_t         header[HistoryDumpHeaderSize];
+
+    // The LVD isr may complete a commit
+    state = enterCritical();
+    head  = historyHead;
+    count = historyCount;
+    exitCritical(state);
+    oldest = (head + HistoryEntryCount - count) % HistoryEntryCount;
+    first  = count;
+
+    header[0] = HistoryDumpMagic;
+    header[1] = HistoryEntrySize;
+    header[2] = count;
+    if (!txPutHeader(header, HistoryDumpHeaderSize, 2)) return 0;
+    if (!count) return 1;
+
+    // The ring wraps, send the part at the end first
+    if (oldest + count > HistoryEntryCount) first = HistoryEntryCount - oldest;
+    txPutIAP(HistoryEntryAddr(oldest), (uint16_t)first * HistoryEntrySize, 0);
+    if (first != count) txPutIAP(HistoryAddr, (uint16_t)(count - first) * HistoryEntrySize, 0);
+    historyDumpDesc = lastTxDesc();
+    historyDumping  = 1;
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma nooverlay
+#include "RecordStore.h"
+
+#if !RecordStoreOnNor
+uint16_t        recordLogFree;
+uint16_t        recordLogNewest;
+uint8_t         recordLogBusy;
+__xdata uint8_t recordLogEntry[CommitRecordSize];
+__xdata uint8_t recordLogAppend[CommitRecordSize];
+
+uint8_t readRecordLogEntry(uint16_t off, uint8_t* out)
+{
+    uint16_t size;
+    uint8_t  i;
+
+    out[0] = readIAPAt(RecordLogAddr + off);
+    out[1] = readIAPAt(RecordLogAddr + off + 1);
+    size   = encodedRecordSize(out);
+    if (!size || size > RecordLogMaxSize || off + size >= IAPSectorSize) return 0;
+
+    writeIAPAddr(RecordLogAddr + off);
+    for (i = 0; i < size; i++) {
+        out[i] = readFromIAP();
+        incIAPAddr();
+    }
+    return size;
+}
+
+void initRecordLog()
+{
+    uint16_t off = 0;
+    uint8_t  size;
+
+    holdIAP();
+    recordLogNewest = RecordLogNone;
+    while (off < IAPSectorSize && readIAPAt(RecordLogAddr + off) != 0xFF) {
+        size = readRecordLogEntry(off, recordLogEntry);
+        // Broken header, make the next append erase the sector
+        if (!size) {
+            off = IAPSectorSize;
+            break;
+        }
+        if (readIAPAt(RecordLogAddr + off + size) == RecordLogMark) recordLogNewest = off;
+        off += size + 1;
+    }
+    recordLogFree = off;
+    releaseIAP();
+}
+
+void onRecordLogCommitted(uint16_t addr)
+{
+    recordLogBusy = 0;
+}
+
+uint8_t appendRecordLog(const uint8_t* record, uint8_t size)
+{
+    uint16_t off   = recordLogFree;
+    uint8_t  erase = 0;
+    uint8_t  i;
+
+    if (recordLogBusy || size > RecordLogMaxSize) return 0;
+
+    for (i = 0; i < size; i++)
+        recordLogAppend[i] = record[i];
+    recordLogAppend[size] = RecordLogMark;
+
+    if (off + size + 1 > IAPSectorSize) {
+        off   = 0;
+        erase = 1;
+    }
+    if (!requestCommit(RecordLogAddr + off, recordLogAppend, size + 1, erase, onRecordLogCommitted)) return 0;
+
+    recordLogBusy   = 1;
+    recordLogNewest = off;
+    recordLogFree   = off + size + 1;
+    return 1;
+}
+
+uint8_t readNewestEntry()
+{
+    uint8_t size;
+
+    if (recordLogNewest == RecordLogNone) return 0;
+    holdIAP();
+    size = readRecordLogEntry(recordLogNewest, recordLogEntry);
+    releaseIAP();
+    return size;
+}
+
+uint8_t readNewestRecord(uint8_t* out, uint8_t maxLen)
+{
+    if (!readNewestEntry()) return 0;
+    return decodeRecord(recordLogEntry, out, maxLen);
+}
+#endif
\ No newline at end of file
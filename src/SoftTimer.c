@@ -0,0 +1,122 @@
+#pragma nooverlay
+#include "SoftTimer.h"
+
+__xdata SoftTimer_t softTimers[SoftTimerCount];
+__xdata uint8_t     softWheel[SoftWheelSlots * 2];
+uint8_t             softTimerUsed;
+uint32_t            sysTickMs;
+
+void initSoftTimer()
+{
+    uint8_t i;
+    for (i = 0; i < SoftWheelSlots * 2; i++)
+        softWheel[i] = SoftTimerNone;
+    softTimerUsed = 0;
+    sysTickMs     = 0;
+}
+
+uint32_t getSysTickMs()
+{
+    uint8_t  enabled = maskInterrupt(InterruptTimer0);
+    uint32_t tick    = sysTickMs;
+    unmaskInterrupt(enabled);
+    return tick;
+}
+
+uint8_t createSoftTimer(SoftTimerCallback_t callback)
+{
+    if (softTimerUsed == SoftTimerCount) return SoftTimerNone;
+    softTimers[softTimerUsed].callback = callback;
+    softTimers[softTimerUsed].slot     = SoftTimerNone;
+    return softTimerUsed++;
+}
+
+void queueSoftTimer(uint8_t id)
+{
+    __xdata SoftTimer_t* timer = &softTimers[id];
+    uint16_t             now   = sysTickMs;
+    uint16_t             delta = timer->expires - now;
+    uint8_t              slot;
+
+    if (delta < SoftWheelSlots)
+        slot = timer->expires & SoftWheelMask;
+    else if (delta < SoftWheelSlots * SoftWheelSlots)
+        slot = SoftWheelSlots + ((timer->expires >> SoftWheelBits) & SoftWheelMask);
+    else
+        // Too far, queue it to the last round and check again when cascaded
+        slot = SoftWheelSlots + (((now >> SoftWheelBits) - 1) & SoftWheelMask);
+
+    timer->slot = slot;
+    timer->prev = SoftTimerNone;
+    timer->next = softWheel[slot];
+    if (timer->next != SoftTimerNone) softTimers[timer->next].prev = id;
+    softWheel[slot] = id;
+}
+
+void unqueueSoftTimer(uint8_t id)
+{
+    __xdata SoftTimer_t* timer = &softTimers[id];
+
+    if (timer->slot == SoftTimerNone) return;
+    if (timer->slot == SoftTimerFiring) {
+        timer->slot = SoftTimerNone;
+        return;
+    }
+    if (timer->prev != SoftTimerNone)
+        softTimers[timer->prev].next = timer->next;
+    else
+        softWheel[timer->slot] = timer->next;
+    if (timer->next != SoftTimerNone) softTimers[timer->next].prev = timer->prev;
+    timer->slot = SoftTimerNone;
+}
+
+void startSoftTimer(uint8_t id, uint16_t delayMs)
+{
+    CriticalState_t state = enterCritical();
+    unqueueSoftTimer(id);
+    softTimers[id].expires = (uint16_t)sysTickMs + (delayMs ? delayMs : 1);
+    queueSoftTimer(id);
+    exitCritical(state);
+}
+
+void cancelSoftTimer(uint8_t id)
+{
+    CriticalState_t state = enterCritical();
+    unqueueSoftTimer(id);
+    exitCritical(state);
+}
+
+void onSoftTimerTick()
+{
+    uint8_t         expired[SoftTimerCount];
+    uint8_t         count = 0, id, next, i, firing;
+    uint8_t         now;
+    CriticalState_t state = enterCritical();
+
+    now = ++sysTickMs;
+    // A round of level 0 passed, move the timers of this round down
+    if (!(now & SoftWheelMask)) {
+        for (id = takeSoftWheelSlot(SoftWheelSlots + ((sysTickMs >> SoftWheelBits) & SoftWheelMask));
+             id != SoftTimerNone;
+             id = next) {
+            next = softTimers[id].next;
+            queueSoftTimer(id);
+        }
+    }
+
+    // Callbacks may start or cancel timers, don't walk the list while calling them
+    for (id = takeSoftWheelSlot(now & SoftWheelMask); id != SoftTimerNone; id = softTimers[id].next) {
+        softTimers[id].slot = SoftTimerFiring;
+        expired[count++]    = id;
+    }
+    exitCritical(state);
+    for (i = 0; i < count; i++) {
+        id = expired[i];
+        // Cancelled or restarted by an earlier callback
+        state  = enterCritical();
+        firing = softTimers[id].slot == SoftTimerFiring;
+        if (firing) softTimers[id].slot = SoftTimerNone;
+        exitCritical(state);
+        if (firing) softTimers[id].callback();
+    }
+}
\ No newline at end of file
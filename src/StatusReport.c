@@ -0,0 +1,20 @@
+#include "StatusReport.h"
+
+uint8_t sendStatus()
+{
+    // Every part goes into the ring, so the line is never cut
+    if (txRingFree() < StatusMaxSize) return 0;
+    // The sampler only runs while streaming, the report waits for a frame of its own otherwise
+    if (!refreshSamplerLevels()) return 0;
+    txPutByte(StatusMagic);
+    txPutByte(' ');
+    txPutDec32(getSysTickMs());
+    txPutByte(' ');
+    txPutDec8(rxDropped);
+    txPutByte(' ');
+    txPutDec8(samplesDropped);
+    txPutByte(' ');
+    txPutDec16(readSamplerLevel(0));
+    txPutByte('\n');
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include "TraceDump.h"
+
+#if TraceEnabled
+uint8_t dumpTrace()
+{
+    uint8_t header[TraceDumpHeaderSize];
+
+    traceFrozen = 1;
+    header[0]   = TraceDumpMagic;
+    header[1]   = traceWrapped ? TraceRingSize : traceHead;
+    if (!txPutHeader(header, TraceDumpHeaderSize, 2)) {
+        traceFrozen = 0;
+        return 0;
+    }
+    if (traceWrapped)
+        txPutMemory((const char*)&traceRing[traceHead], (TraceRingSize - traceHead) * sizeof(TraceRecord_t), 0);
+    if (traceHead) txPutMemory((const char*)traceRing, traceHead * sizeof(TraceRecord_t), 0);
+    return 1;
+}
+
+void stepTrace()
+{
+    if (!traceFrozen || !isTxIdle()) return;
+    traceHead    = 0;
+    traceWrapped = 0;
+    traceFrozen  = 0;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma nooverlay
+#include "WriteBackCache.h"
+
+__xdata uint8_t cacheData[RecordLogMaxSize];
+uint8_t         cacheLen;
+uint8_t         cacheDirty;
+uint8_t         cacheQuietTimer;
+uint8_t         cacheAgeTimer;
+
+uint8_t flushCache()
+{
+    uint8_t         flushed = 1;
+    CriticalState_t state   = enterCritical();
+    if (cacheDirty) {
+        flushed = appendRecordLog(cacheData, cacheLen);
+        if (flushed) cacheDirty = 0;
+    }
+    exitCritical(state);
+    if (flushed) {
+        cancelSoftTimer(cacheQuietTimer);
+        cancelSoftTimer(cacheAgeTimer);
+    }
+    return flushed;
+}
+
+uint8_t cacheRecord(const uint8_t* data, uint8_t len)
+{
+    CriticalState_t state;
+    uint8_t         i, wasDirty;
+
+    if (len > RecordLogMaxSize) return 0;
+
+    state = enterCritical();
+    cacheLen = len;
+    for (i = 0; i < len; i++)
+        cacheData[i] = data[i];
+    wasDirty   = cacheDirty;
+    cacheDirty = 1;
+    exitCritical(state);
+
+    startSoftTimer(cacheQuietTimer, CacheQuietMs);
+    if (!wasDirty) startSoftTimer(cacheAgeTimer, CacheMaxAgeMs);
+    return 1;
+}
+
+void onCacheExpired()
+{
+    // Retry in next tick if the previous append is not committed yet
+    if (!flushCache()) startSoftTimer(cacheQuietTimer, 1);
+}
+
+void onCacheUrged()
+{
+    flushCache();
+}
+
+void initCache()
+{
+    cacheQuietTimer = createSoftTimer(onCacheExpired);
+    cacheAgeTimer   = createSoftTimer(onCacheExpired);
+    commitUrgeHook  = onCacheUrged;
+}
+
+void onLowVoltage()
+{
+    urgeRecordLog();
+    if (flushCache()) urgeRecordLog();
+}
\ No newline at end of file
@@ -1,27 +1,161 @@
 #include "BoardBase.h"
+#include "BootProfile.h"
 
+#include "STC/ADC/ADC.h"
 #include "STC/Interrupt.h"
+#include "STC/LVD/LVD.h"
+#include "STC/PCA/PCA.h"
 #include "STC/Timer/Timer.h"
+#include "STC/Trace.h"
+#include "STC/UART/Autobaud.h"
+#include "STC/UART/FlowControl.h"
+#include "STC/UART/RxFrame.h"
+#include "STC/UART/TxQueue.h"
 #include "STC/UART/UART.h"
 
+#include "ADCSampler.h"
 #include "AlphaSender.h"
+#include "BusNode.h"
+#include "ConfigStore.h"
+#include "EEPROMCommitter.h"
 #include "LedBlinker.h"
+#include "RecordHistory.h"
+#include "RecordStore.h"
+#include "SoftTimer.h"
+#include "StatusReport.h"
+#include "WriteBackCache.h"
+#if TraceEnabled
+#include "TraceDump.h"
+#endif
+#if RecordStoreOnNor
+#include "STC/SPI/SPI.h"
+#endif
 
 /**
  * @brief ISR Handler for Timer 0
  */
 INTERRUPT(isrTimer0, 1)
 {
+    TRACE(TraceTimer0Enter);
     reloadTimer(Timer0, ToReloadValueDIV12(SysClockOfOneMs));
-    onSysTickOneMs();
+    onSoftTimerTick();
+    pollFlow();
+    TRACE(TraceTimer0Exit);
 }
 
 INTERRUPT(isrUART1, 4)
 {
+    TRACE(TraceUART1Enter);
     if (checkRI(Port1)) {
-        sendAlpha(readPort(Port1));
+        uint8_t data = readPort(Port1);
         clearRI(Port1);
+#if AddressedBusMode
+        if (acceptBusFrame(data)) onRxByte(data);
+#else
+        onRxByte(data);
+#endif
     }
+    if (checkTI(Port1)) {
+        clearTI(Port1);
+        onTxReady();
+    }
+    TRACE(TraceUART1Exit);
+}
+
+/**
+ * @brief ISR Handler for ADC
+ */
+INTERRUPT(isrADC, 5)
+{
+    TRACE(TraceADCEnter);
+    onADCDone();
+    TRACE(TraceADCExit);
+}
+
+/**
+ * @brief ISR Handler for PCA
+ */
+INTERRUPT(isrPCA, 7)
+{
+    TRACE(TracePCAEnter);
+    if (checkCCF(RxIdleModule)) {
+        clearCCF(RxIdleModule);
+        onRxIdle();
+    }
+    if (checkCCF(LedModule)) {
+        clearCCF(LedModule);
+        onLedMatch();
+    }
+    TRACE(TracePCAExit);
+}
+
+#if RecordStoreOnNor
+/**
+ * @brief ISR Handler for SPI
+ */
+INTERRUPT(isrSPI, 9)
+{
+    TRACE(TraceSPIEnter);
+    onSPIDone();
+    TRACE(TraceSPIExit);
+}
+#endif
+
+/**
+ * @brief ISR Handler for Low Voltage Detect
+ */
+INTERRUPT(isrLVD, 6)
+{
+    TRACE(TraceLVDEnter);
+    clearLVDF();
+    onLowVoltage();
+    TRACE(TraceLVDExit);
+}
+
+/**
+ * @brief Baud rate of UART1, the fallback rate with UART1Autobaud
+ */
+#define UART1Baud 9600
+
+/**
+ * @brief Set to 1 to detect the baud rate of the host at boot, see Autobaud.h
+ */
+#define UART1Autobaud 0
+
+#define BoardBaudGen (SimBaudTimer1 ? Timer_1 : Timer_BRT)
+
+#if UART1Autobaud && AddressedBusMode
+#error "Autobaud needs a point to point link"
+#endif
+
+/**
+ * @brief Register images of Timer0, the baud generator and UART1, computed at compile time
+ */
+#define BoardTMOD                                                      \
+    (TimerTMODImage(Timer0, SysClock_DIV_12, Counter_BIT_16, Ignore) | \
+     (SimBaudTimer1 ? TimerTMODImage(Timer1, SysClock_DIV_12, Counter_BIT_8_AutoReload, Ignore) : 0x00))
+#define BoardAUXR \
+    (TimerAUXRImage(Timer0, SysClock_DIV_12) | BRTAUXRImage(SysClock_DIV_12) | PortAUXRImage(Port1, BoardBaudGen, Normal))
+#define BoardSCON PortSCONImage(AddressedBusMode ? EUART : UART8, BoardBaudGen)
+#define BoardPCON PortPCONImage(Port1, Normal)
+
+/**
+ * @brief Write the register images, call it first
+ */
+void initRegisters()
+{
+    TMOD = BoardTMOD;
+#if SimBaudTimer1
+    reloadTimer(Timer1, BaudToReloadValueDIV12(UART1Baud));
+    startTimer(Timer1);
+#else
+    reloadBRT(BaudToReloadValueDIV12(UART1Baud));
+#endif
+    // Starts BRT
+    AUXR = BoardAUXR;
+    // Keep LVDF and POF
+    PCON = (PCON & 0x3F) | BoardPCON;
+    SCON = BoardSCON;
 }
 
 /**
@@ -29,27 +163,152 @@ INTERRUPT(isrUART1, 4)
  */
 void initTimer0()
 {
-    TimerCfg_t cfg = {.source = SysClock_DIV_12, .mode = Counter_BIT_16, .gate = Ignore, .it = EnableIT};
-    configureTimer(Timer0, &cfg);
     reloadTimer(Timer0, ToReloadValueDIV12(SysClockOfOneMs));
     startTimer(Timer0);
+    IE |= TimerIEImage(Timer0, EnableIT);
+}
+
+/**
+ * @brief Run before the startup code of SDCC, right after reset
+ *
+ * Starts the PCA counter for the boot profile, with the configuration of
+ * initPCA(). With FastBoot, clears the IRAM below the stack and returns 1 to
+ * skip the startup code: no global has an initializer, and every module
+ * clears its XRAM in its init, so the 1 KB XRAM clear is not needed.
+ */
+unsigned char _sdcc_external_startup(void) __naked
+{
+    // clang-format off
+    __asm
+    mov  _CMOD, #0x00
+    mov  _CL, #0x00
+    mov  _CH, #0x00
+    setb _CR
+#if FastBoot
+    ; Clear from below the return address down to bank 1, r0 is in bank 0
+    mov  a, sp
+    add  a, #0xFE
+    mov  r0, a
+00001$:
+    mov  @r0, #0x00
+    dec  r0
+    cjne r0, #0x07, 00001$
+    mov  dpl, #0x01
+#else
+    mov  dpl, #0x00
+#endif
+    ret
+    __endasm;
+    // clang-format on
+}
+
+/**
+ * @brief Initialize PCA counter, kept counting if started by _sdcc_external_startup()
+ */
+void initPCA()
+{
+    PCACfg_t cfg = {.source = PCAClockSource, .runInIdle = 1, .overflowIT = DisableIT};
+    if (!CR) configurePCA(&cfg);
+    startPCA();
 }
 
 void initUART1()
 {
-    setBRTSource(SysClock_DIV_12);
-    PortCfg_t cfg = {.mode = UART8, .baudGen = Timer_BRT, .baudMode = Normal, .it = EnableIT};
-    reloadBRT(BaudToReloadValueDIV12(9600));
+    uint32_t baud = UART1Baud;
+
+#if AddressedBusMode
+    initBusNode();
+#endif
+#if UART1Autobaud
+    baud = detectBaud(UART1Baud);
+#endif
+
+    initFlowControl();
     REN = 1;
+    IE |= PortIEImage(Port1, EnableIT);
+    initRxFrame(baud);
+}
 
-    configurePort(Port1, &cfg);
+/**
+ * @brief Handle a request byte, call it when the TX queue has 3 free descriptors
+ *
+ * @param request request byte
+ * @return non-zero if handled, zero to retry once the TX ring has room
+ */
+uint8_t handleRequest(uint8_t request)
+{
+    switch (request) {
+        case HistoryDumpRequest: return dumpHistory();
+        case SamplerStreamRequest: return toggleSampleStream();
+        case BootProfileRequest: return dumpBootProfile();
+#if TraceEnabled
+        case TraceDumpRequest: return dumpTrace();
+#endif
+        case StatusRequest: return sendStatus();
+        default: sendAlpha(request); return 1;
+    }
 }
 
+/**
+ * @brief Frame being handled by the main loop
+ */
+__xdata uint8_t frame[RxRingSize];
+
 void main()
 {
-    enableGlobalInterrupt();
+    uint8_t len = 0, pos = 0;
+
+    markBoot(BootStartup);
+    initRegisters();
+    // LVDF is set on power up
+    clearLVDF();
+    initSoftTimer();
+    initCommitter();
+    erasePauseHook  = pauseRxForErase;
+    eraseResumeHook = resumeRxAfterErase;
+    initCache();
     initTimer0();
+    initPCA();
+    markBoot(BootCore);
+
+    initConfigStore();
+    initRecordLog();
+    // The LVD isr commits through the committer, the cache and the record log, XRAM is not cleared before their init
+    enableLVDInterrupt();
+    enableGlobalInterrupt();
+    markBoot(BootStores);
+
     initUART1();
     sendSavedData();
-    while (1) {}
+    markBoot(BootReady);
+
+    // Not needed to answer the first request
+    initSampler();
+    playLedRoutine(blinkRoutine, BlinkRoutineLen);
+    initHistory();
+    markBoot(BootDeferred);
+
+    while (1) {
+        if (pos == len) {
+            len = takeRxFrame(frame, RxRingSize);
+            pos = 0;
+        }
+        // Each request takes at most three descriptors
+#if AddressedBusMode
+        // The address follows in the same frame, it is dropped if missing
+        else if (frame[pos] == NodeAddrRequest) {
+            if (++pos < len) setNodeAddr(frame[pos++]);
+        }
+#endif
+        else if (txDescFree() >= 3) {
+            if (handleRequest(frame[pos])) pos++;
+        }
+        pumpSamples();
+        stepRecordLog();
+        stepHistory();
+        stepCommit();
+#if TraceEnabled
+        stepTrace();
+#endif
+    }
 }
\ No newline at end of file
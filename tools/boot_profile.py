@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""Fetch and decode the boot profile of include/BootProfile.h.
+
+The dump is 'B', the phase count, then per phase the little endian PCA
+counter at its end. The counter starts at reset and ticks every 12 clocks,
+it wraps every 71 ms, so each phase must be shorter than that.
+
+--compare takes a dump saved by --save, e.g. of a build with -DFastBoot=0,
+and prints the time of each phase in both next to each other:
+
+    tools/ucsim_pty.py firmware-slow.hex &
+    tools/boot_profile.py /tmp/ttyWindmill --save slow.bin
+    tools/ucsim_pty.py firmware.hex &
+    tools/boot_profile.py /tmp/ttyWindmill --compare slow.bin
+"""
+
+import argparse
+import os
+import select
+import sys
+import termios
+import time
+import tty
+
+# BootPhase_t in BootProfile.h
+PHASES = ["Startup", "Core", "Stores", "Ready", "Deferred"]
+
+DUMP_REQUEST = b"@"
+DUMP_MAGIC = ord("B")
+MARK_SIZE = 2
+
+SYS_CLOCK = 11059200
+TICK_US = 12 / SYS_CLOCK * 1e6
+
+
+def fetch(port, baud, timeout):
+    fd = os.open(port, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    attrs[4] = attrs[5] = getattr(termios, f"B{baud}")
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+    os.write(fd, DUMP_REQUEST)
+
+    data = b""
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        ready, _, _ = select.select([fd], [], [], 0.05)
+        if ready:
+            data += os.read(fd, 4096)
+        start = data.find(bytes([DUMP_MAGIC]))
+        if start >= 0 and len(data) > start + 1 and len(data) >= start + 2 + data[start + 1] * MARK_SIZE:
+            break
+    os.close(fd)
+    return data
+
+
+def parse(data):
+    """Ticks of each phase, from the end of the one before."""
+    start = data.find(bytes([DUMP_MAGIC]))
+    if start < 0 or len(data) < start + 2:
+        sys.exit("no boot profile received")
+    count = data[start + 1]
+    body = data[start + 2 : start + 2 + count * MARK_SIZE]
+    if len(body) < count * MARK_SIZE:
+        sys.exit(f"dump truncated, {len(body) // MARK_SIZE} of {count} marks")
+    ticks = []
+    last = 0
+    for i in range(0, len(body), MARK_SIZE):
+        mark = body[i] | body[i + 1] << 8
+        ticks.append((mark - last) & 0xFFFF)
+        last = mark
+    return ticks
+
+
+def phase_name(i):
+    return PHASES[i] if i < len(PHASES) else f"Phase{i}"
+
+
+def report(ticks, baseline):
+    if baseline is None:
+        print(f"{'phase':>10} {'us':>10} {'total us':>10}")
+    else:
+        print(f"{'phase':>10} {'before us':>10} {'after us':>10} {'saved us':>10}")
+    total = 0
+    for i, t in enumerate(ticks):
+        total += t
+        if baseline is None:
+            print(f"{phase_name(i):>10} {t * TICK_US:>10.1f} {total * TICK_US:>10.1f}")
+        else:
+            b = baseline[i] if i < len(baseline) else 0
+            print(f"{phase_name(i):>10} {b * TICK_US:>10.1f} {t * TICK_US:>10.1f} {(b - t) * TICK_US:>10.1f}")
+    # Ready is when the first request gets an answer
+    ready = min(len(ticks), PHASES.index("Ready") + 1)
+    after = sum(ticks[:ready])
+    if baseline is None:
+        print(f"reset to ready {after * TICK_US:.1f} us")
+    else:
+        before = sum(baseline[:ready])
+        print(f"reset to ready {before * TICK_US:.1f} us -> {after * TICK_US:.1f} us")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("port", nargs="?", help="serial device or pty to request the dump from")
+    parser.add_argument("--baud", type=int, default=9600, help="baud rate (default: %(default)s)")
+    parser.add_argument("--file", help="decode a saved dump instead")
+    parser.add_argument("--save", help="save the raw dump")
+    parser.add_argument("--compare", help="saved dump to compare with, e.g. without FastBoot")
+    parser.add_argument("--timeout", type=float, default=2, help="s to wait for the dump (default: %(default)s)")
+    args = parser.parse_args()
+
+    if args.file:
+        with open(args.file, "rb") as f:
+            data = f.read()
+    elif args.port:
+        data = fetch(args.port, args.baud, args.timeout)
+    else:
+        parser.error("a port or --file is needed")
+    if args.save:
+        with open(args.save, "wb") as f:
+            f.write(data)
+
+    baseline = None
+    if args.compare:
+        with open(args.compare, "rb") as f:
+            baseline = parse(f.read())
+    report(parse(data), baseline)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
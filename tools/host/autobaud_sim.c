@@ -0,0 +1,328 @@
+/*
+ * Check of Autobaud.h at every standard rate against a host sending sync bytes
+ *
+ * The host writes AutobaudSync every HostSyncMs until it reads AutobaudAck,
+ * as tools/uart_load.py does, with its clock up to 2% off. It reads the ack
+ * 1 ms after its stop bit, or 30 ms like behind the latency timer of a USB
+ * bridge, the sync bytes written meanwhile still go out. It then sends a
+ * request byte, once while the firmware settles and once after.
+ *
+ * RXD is polled every PollClocks, the time a polling loop of the 1T core
+ * takes, or of the 12T core of ucsim with SimBaudTimer1. UART1 samples RXD
+ * at the rate loaded into BRT, or Timer1 with SimBaudTimer1, and only sets
+ * RI while REN is set.
+ *
+ *     tools/host/build.sh autobaud_sim
+ *     tools/host/build.sh autobaud_sim -DSimBaudTimer1=1
+ *
+ * A rate must lock and the first byte received after detectBaud() returns
+ * must be the request. With SimBaudTimer1 only the rates Timer1 makes must
+ * lock, the others must keep the fallback. Exits non-zero otherwise.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "STC/UART/Autobaud.h"
+
+// The model reaches the registers directly, the firmware through hostPoll()
+#undef P30
+#undef RI
+#undef TI
+#undef REN
+#undef SBUF
+#undef TL1
+#undef TH1
+#undef TF1
+#undef TR1
+#undef CL
+#undef CH
+
+#ifndef HostSyncMs
+#define HostSyncMs 20
+#endif
+#ifndef PollClocks
+#define PollClocks (SimBaudTimer1 ? 36 : 6)
+#endif
+#define FallbackBaud 9600
+#define RequestByte 'h'
+#define HostBytes 256
+#define Never UINT64_MAX
+
+static uint64_t now;
+
+// Bytes the host put on the line, in order
+static struct
+{
+    uint64_t start, bitClocks;
+    uint8_t  value;
+} hostBytes[HostBytes];
+static unsigned hostCount, edgeScan;
+static uint64_t hostNextSync, hostAckAt, hostRequestAt, hostBitClocks;
+static unsigned hostLatencyMs, hostRequestMs;
+
+static int      rxActive;
+static uint64_t rxFrom, rxEdge, rxBitClocks;
+static uint8_t  sbufRx;
+static unsigned rxBytes;
+
+static uint64_t txEnd = Never;
+static uint8_t  txByte;
+
+static uint64_t t1At;
+
+static void hostSend(uint64_t at, uint8_t value)
+{
+    if (hostCount && at < hostBytes[hostCount - 1].start + 10 * hostBytes[hostCount - 1].bitClocks)
+        at = hostBytes[hostCount - 1].start + 10 * hostBytes[hostCount - 1].bitClocks;
+    if (hostCount == HostBytes) return;
+    hostBytes[hostCount].start     = at;
+    hostBytes[hostCount].bitClocks = hostBitClocks;
+    hostBytes[hostCount].value     = value;
+    hostCount++;
+}
+
+/**
+ * @brief Level of RXD at a time, the line idles high
+ */
+static int lineLevel(uint64_t t)
+{
+    static unsigned hint;
+    unsigned        bit;
+
+    if (hint >= hostCount) hint = 0;
+    while (hint && hostBytes[hint].start > t)
+        hint--;
+    while (hint + 1 < hostCount && hostBytes[hint + 1].start <= t)
+        hint++;
+    if (!hostCount || hostBytes[hint].start > t) return 1;
+    bit = (t - hostBytes[hint].start) / hostBytes[hint].bitClocks;
+    if (bit == 0) return 0;
+    if (bit <= 8) return hostBytes[hint].value >> (bit - 1) & 1;
+    return 1;
+}
+
+/**
+ * @brief First 1 to 0 transition of RXD at or after a time, Never if none up to now
+ */
+static uint64_t nextFallingEdge(uint64_t from)
+{
+    unsigned i, bit;
+    uint64_t t;
+
+    // Bytes over before from are never looked at again
+    while (edgeScan < hostCount && hostBytes[edgeScan].start + 10 * hostBytes[edgeScan].bitClocks < from)
+        edgeScan++;
+    for (i = edgeScan; i < hostCount; i++) {
+        for (bit = 0; bit < 10; bit++) {
+            t = hostBytes[i].start + bit * hostBytes[i].bitClocks;
+            if (t > now) return Never;
+            if (t >= from && t && lineLevel(t - 1) && !lineLevel(t)) return t;
+        }
+    }
+    return Never;
+}
+
+/**
+ * @brief SysClock per bit of UART1, from the baud generator loaded
+ */
+static uint64_t deviceBitClocks()
+{
+#if SimBaudTimer1
+    return 32 * 12 * (uint64_t)(256 - TH1);
+#else
+    return 32 * (uint64_t)(256 - BRT) * (AUXR & 0x04 ? 1 : 12);
+#endif
+}
+
+static void syncHost()
+{
+    // The ack ends the syncs once read
+    if (txEnd <= now) {
+        if (txByte == AutobaudAck && hostAckAt == Never) {
+            hostAckAt     = txEnd + (uint64_t)hostLatencyMs * SysClockOfOneMs;
+            hostRequestAt = hostAckAt + (uint64_t)hostRequestMs * SysClockOfOneMs;
+        }
+        txEnd = Never;
+        TI    = 1;
+    }
+    while (hostNextSync <= now && hostNextSync < hostAckAt) {
+        hostSend(hostNextSync, AutobaudSync);
+        hostNextSync += (uint64_t)HostSyncMs * SysClockOfOneMs;
+    }
+    if (hostRequestAt <= now) {
+        hostSend(hostRequestAt, RequestByte);
+        hostRequestAt = Never;
+    }
+}
+
+static void syncTimer1()
+{
+    uint64_t clocks = SimBaudTimer1 || !(AUXR & 0x40) ? 12 : 1;
+    uint64_t counts = (now - t1At) / clocks;
+    uint32_t value;
+
+    if (!TR1) {
+        t1At = now;
+        return;
+    }
+    t1At += counts * clocks;
+    if ((TMOD >> 4 & 3) == 2) {
+        value = TL1 + counts;
+        if (value > 0xFF) {
+            TF1   = 1;
+            value = TH1 + (value - 0x100) % (0x100 - TH1);
+        }
+        TL1 = value;
+    } else {
+        value = (TH1 << 8 | TL1) + counts;
+        if (value > 0xFFFF) TF1 = 1;
+        TH1 = value >> 8;
+        TL1 = value;
+    }
+}
+
+/**
+ * @brief Receive what RXD carried since the last poll, as UART1 in mode 1 does
+ */
+static void syncReceiver()
+{
+    uint8_t value;
+    int     bit;
+
+    if (!REN) {
+        rxActive = 0;
+        rxFrom   = now;
+        return;
+    }
+    for (;;) {
+        if (!rxActive) {
+            rxEdge = nextFallingEdge(rxFrom);
+            if (rxEdge == Never) return;
+            rxActive    = 1;
+            rxBitClocks = deviceBitClocks();
+        }
+        // RI is set in the middle of the stop bit
+        if (rxEdge + rxBitClocks * 19 / 2 > now) return;
+        rxActive = 0;
+        rxFrom   = rxEdge + rxBitClocks * 19 / 2;
+        // A false start bit
+        if (lineLevel(rxEdge + rxBitClocks / 2)) continue;
+        value = 0;
+        for (bit = 1; bit <= 8; bit++)
+            value |= lineLevel(rxEdge + rxBitClocks * bit + rxBitClocks / 2) << (bit - 1);
+        if (RI) continue;
+        SBUF = sbufRx = value;
+        RI   = 1;
+        rxBytes++;
+    }
+}
+
+volatile uint8_t* hostPoll(volatile uint8_t* reg)
+{
+    uint16_t ticks;
+
+    now += PollClocks;
+    // SBUF changed since the last poll, the firmware started sending
+    if (SBUF != sbufRx) {
+        txByte = SBUF;
+        SBUF   = sbufRx;
+        txEnd  = now + 10 * deviceBitClocks();
+    }
+    syncHost();
+    syncTimer1();
+    syncReceiver();
+    P30   = lineLevel(now);
+    ticks = now / 12;
+    CL    = ticks;
+    CH    = ticks >> 8;
+    return reg;
+}
+
+/**
+ * @brief Reset the chip and the host, as initRegisters() leaves UART1 at the fallback rate
+ */
+static void reset(uint32_t baud, int errorPercent, unsigned latencyMs, unsigned requestMs, uint64_t firstSync)
+{
+    memset(hostBytes, 0, sizeof hostBytes);
+    hostCount     = 0;
+    edgeScan      = 0;
+    hostBitClocks = SysClock * 100 / (baud * (100 + errorPercent));
+    hostNextSync  = firstSync;
+    hostAckAt = hostRequestAt = Never;
+    hostLatencyMs = latencyMs;
+    hostRequestMs = requestMs;
+    rxActive      = 0;
+    rxBytes       = 0;
+    txEnd         = Never;
+    now = rxFrom = t1At = 0;
+    SBUF = sbufRx = 0;
+    RI = TI = REN = TF1 = TR1 = 0;
+
+#if SimBaudTimer1
+    TMOD = TimerTMODImage(Timer1, SysClock_DIV_12, Counter_BIT_8_AutoReload, Ignore);
+    TH1 = TL1 = BaudToReloadValueDIV12(FallbackBaud);
+    TR1       = 1;
+    AUXR      = 0;
+#else
+    TMOD = 0;
+    BRT  = BaudToReloadValueDIV12(FallbackBaud);
+    AUXR = BRTAUXRImage(SysClock_DIV_12) | PortAUXRImage(Port1, Timer_BRT, Normal);
+#endif
+}
+
+static int isLockable(uint32_t baud)
+{
+    return !SimBaudTimer1 || SysClock / 32 / 12 % baud == 0;
+}
+
+static int run(uint32_t baud, int errorPercent, unsigned latencyMs, unsigned requestMs, uint64_t firstSync)
+{
+    uint32_t locked;
+    uint64_t deadline;
+    int      lockable = isLockable(baud);
+    uint8_t  first    = 0;
+
+    reset(baud, errorPercent, latencyMs, requestMs, firstSync);
+    locked = detectBaud(FallbackBaud);
+    if (locked != (lockable ? baud : FallbackBaud)) {
+        printf("%6lu baud %+d%%: got %lu\n", (unsigned long)baud, errorPercent, (unsigned long)locked);
+        return 1;
+    }
+    if (!lockable) return 0;
+    // What initUART1() receives first
+    *hostPoll(&REN) = 1;
+    deadline        = now + 500 * (uint64_t)SysClockOfOneMs;
+    while (!*hostPoll(&RI) && now < deadline)
+        ;
+    if (RI) first = SBUF;
+    if (first != RequestByte) {
+        printf("%6lu baud %+d%%, ack read after %u ms, request %u ms later: first byte 0x%02X\n", (unsigned long)baud,
+               errorPercent, latencyMs, requestMs, first);
+        return 1;
+    }
+    return 0;
+}
+
+int main()
+{
+    static const uint32_t rates[]     = {1200, 2400, 4800, 9600, 14400, 19200, 28800, 38400, 57600, 115200};
+    static const int      errors[]    = {-2, 0, 2};
+    static const unsigned latencies[] = {1, 30};
+    static const unsigned requests[]  = {AutobaudSettleMs / 2, AutobaudSettleMs * 2};
+    unsigned              r, e, l, q, failed = 0, runs = 0, locks = 0;
+
+    for (r = 0; r < sizeof rates / sizeof rates[0]; r++) {
+        for (e = 0; e < sizeof errors / sizeof errors[0]; e++) {
+            for (l = 0; l < sizeof latencies / sizeof latencies[0]; l++) {
+                for (q = 0; q < sizeof requests / sizeof requests[0]; q++) {
+                    // Vary where the first sync falls in the polling
+                    failed += run(rates[r], errors[e], latencies[l], requests[q],
+                                  (3 + r + e * 7 + l * 11 + q * 5) * (uint64_t)SysClockOfOneMs / 3);
+                    runs++;
+                    locks += isLockable(rates[r]);
+                }
+            }
+        }
+    }
+    printf("SimBaudTimer1 %d: %u runs, %u expected to lock, %u failed\n", SimBaudTimer1, runs, locks, failed);
+    return failed != 0;
+}
@@ -0,0 +1,23 @@
+/*
+ * Forced include of autobaud_sim.c, after host.h
+ *
+ * Each access to the registers autobaud polls goes through hostPoll(),
+ * which lets the polling time pass and brings the line, Timer1, the PCA
+ * counter and UART1 up to date before the access.
+ */
+#pragma once
+#include "stdint.h"
+
+volatile uint8_t* hostPoll(volatile uint8_t* reg);
+
+#define P30 (*hostPoll(&P30))
+#define RI (*hostPoll(&RI))
+#define TI (*hostPoll(&TI))
+#define REN (*hostPoll(&REN))
+#define SBUF (*hostPoll(&SBUF))
+#define TL1 (*hostPoll(&TL1))
+#define TH1 (*hostPoll(&TH1))
+#define TF1 (*hostPoll(&TF1))
+#define TR1 (*hostPoll(&TR1))
+#define CL (*hostPoll(&CL))
+#define CH (*hostPoll(&CH))
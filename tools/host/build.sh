@@ -0,0 +1,30 @@
+#!/bin/sh
+# Build a host simulation against the driver library and the app modules, and run it
+#
+#     tools/host/build.sh flow_sim -DFlowControl=FlowXonXoff
+#
+# The remaining arguments are passed to gcc, e.g. to override a -D setting.
+set -e
+root=$(cd "$(dirname "$0")/../.." && pwd)
+sim=$1
+shift
+out=${TMPDIR:-/tmp}/stc-host-$sim
+rm -rf "$out"
+mkdir -p "$out"
+# SDCC idioms: pragmas of its own, 16-bit keys written to 8-bit SFRs, switches over every port without a return after
+flags="-std=gnu11 -O2 -fcommon -Wall -Wno-unknown-pragmas -Wno-overflow -Wno-switch -Wno-return-type -I$root/tools/host -I$root/include -I$root/src -include $root/tools/host/host.h"
+# A simulation hooks registers in its own forced include
+if [ -f "$root/tools/host/$sim.h" ]; then
+    flags="$flags -include $root/tools/host/$sim.h"
+fi
+flags="$flags $*"
+for f in $(find "$root/lib/STC/src" -name '*.c'); do
+    gcc $flags -c "$f" -o "$out/$(basename "$(dirname "$f")")_$(basename "$f" .c).o"
+done
+# The app modules too, main.c is replaced by the simulation
+for f in "$root"/src/*.c; do
+    [ "$(basename "$f")" = main.c ] || gcc $flags -c "$f" -o "$out/src_$(basename "$f" .c).o"
+done
+ar rcs "$out/libSTC.a" "$out"/*.o
+gcc $flags "$root/tools/host/$sim.c" "$root/tools/host/host.c" "$out/libSTC.a" -o "$out/$sim"
+"$out/$sim"
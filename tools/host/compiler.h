@@ -0,0 +1,23 @@
+/*
+ * gcc stand-in for the compiler.h of SDCC, used by the host builds
+ *
+ * SFRs and SBITs are plain variables, the simulations drive them.
+ */
+#pragma once
+#define __code
+#define __xdata
+#define __data
+#define __idata
+#define __pdata
+#define __near
+#define __bit unsigned char
+#define __interrupt(x)
+#define __critical
+#define __using(x)
+#define __at(x)
+#define __naked
+#define __reentrant
+#define SFR(name, addr) volatile unsigned char name
+#define SBIT(name, addr, bit) volatile unsigned char name
+#define INTERRUPT(name, vector) void name(void)
+#define NOP() do {} while (0)
@@ -0,0 +1,278 @@
+/*
+ * Zero-loss check of the receive path of UART1 while the committer erases
+ *
+ * A peer streams bytes back to back at FlowBaud and reacts to flow control
+ * PeerFifo bytes late, like a USB bridge. The main loop drains frames and
+ * commits a record with an erase every WriteEveryMs, each erase stalls the
+ * CPU for IAPEraseTimeUs. A byte completed while RI is still set overruns.
+ *
+ *     tools/host/build.sh flow_sim -DFlowControl=FlowXonXoff
+ *     tools/host/build.sh flow_sim -DFlowControl=FlowRtsCts
+ *
+ * FlowBaud, PeerFifo, MainLoopClocks, WriteEveryMs and RunMs could be
+ * set by -D too. Exits non-zero if a byte is lost. FlowNone loses bytes as nothing stops
+ * the peer, it is only run to show the check catches it.
+ */
+#include <stdio.h>
+#include "EEPROMCommitter.h"
+#include "STC/UART/RxFrame.h"
+
+// Each could be set by -D
+#ifndef FlowBaud
+#define FlowBaud 115200UL
+#endif
+#ifndef PeerFifo
+#define PeerFifo 16
+#endif
+#ifndef MainLoopClocks
+#define MainLoopClocks 1000
+#endif
+#ifndef WriteEveryMs
+#define WriteEveryMs 100
+#endif
+#ifndef RunMs
+#define RunMs 2000
+#endif
+#define ByteClocks (SysClock * 10 / FlowBaud)
+#define RecordAddr 0x0200
+
+static uint64_t now;
+
+// -1 while the peer is let send, else the bytes it still sends
+static int      peerBudget = -1;
+static int      peerSending, peerDone;
+static uint64_t peerByteEnd;
+static uint8_t  peerNext;
+static uint32_t peerSent;
+
+static int      txActive;
+static uint8_t  txByte;
+static uint64_t txEnd;
+
+static uint16_t idleCompare;
+static int      idleArmed, idleMatched;
+static uint64_t idleAt;
+#if FlowControl == FlowRtsCts
+static uint8_t lastRts;
+#endif
+
+static uint32_t overruns, received, mismatched, longestStop;
+static uint8_t  expected;
+
+static uint8_t nextPeerByte(uint8_t b)
+{
+    return b == '~' ? ' ' : b + 1;
+}
+
+static void syncPCA()
+{
+    uint16_t ticks = now / 12;
+    CL             = ticks;
+    CH             = ticks >> 8;
+}
+
+static void startPeerByte()
+{
+    if (!peerBudget || peerDone) return;
+    if (peerBudget > 0) peerBudget--;
+    peerSending = 1;
+    peerByteEnd = now + ByteClocks;
+}
+
+#if FlowControl != FlowNone
+static uint64_t stoppedAt;
+
+static void stopPeer(int stop)
+{
+    if (stop) {
+        if (peerBudget < 0) {
+            peerBudget = PeerFifo;
+            stoppedAt  = now;
+        }
+    } else if (peerBudget >= 0) {
+        peerBudget = -1;
+        if (now - stoppedAt > longestStop) longestStop = now - stoppedAt;
+        if (!peerSending) startPeerByte();
+    }
+}
+#endif
+
+/**
+ * @brief Follow what the firmware changed: a byte written to SBUF, RTS and the idle timer
+ */
+static void observe()
+{
+    uint16_t compare = CCAP0H << 8 | CCAP0L;
+    uint16_t ticks, delta;
+
+    if (txBusy && !txActive) {
+        txActive = 1;
+        txByte   = SBUF;
+        txEnd    = now + ByteClocks;
+    }
+#if FlowControl == FlowRtsCts
+    if (Rts_P3 != lastRts) {
+        lastRts = Rts_P3;
+        stopPeer(lastRts);
+    }
+#endif
+    // Writing the compare value arms the module
+    if (compare != idleCompare) {
+        idleCompare = compare;
+        CCAPM0 |= 0x40;
+    }
+    idleArmed = CCAPM0 & 0x40;
+    if (idleArmed) {
+        ticks  = now / 12;
+        delta  = idleCompare - ticks;
+        idleAt = (now / 12 + (delta ? delta : 0x10000)) * 12;
+    }
+}
+
+static void receiveAtPeer(uint8_t b)
+{
+#if FlowControl == FlowXonXoff
+    if (b == FlowXoff) stopPeer(1);
+    if (b == FlowXon) stopPeer(0);
+#endif
+    (void)b;
+}
+
+/**
+ * @brief Run the pending isr, as isrUART1 and isrPCA do
+ */
+static void dispatch()
+{
+    uint8_t data;
+    for (;;) {
+        if (RI || TI) {
+            if (RI) {
+                data = SBUF;
+                RI   = 0;
+                onRxByte(data);
+            }
+            if (TI) {
+                TI = 0;
+                onTxReady();
+            }
+        } else if (idleMatched) {
+            idleMatched = 0;
+            onRxIdle();
+        } else {
+            break;
+        }
+        observe();
+    }
+}
+
+/**
+ * @brief Let time pass, the isr only run if the CPU is free
+ */
+static void run(uint64_t until, int cpuFree)
+{
+    uint64_t t;
+    int      event;
+
+    for (;;) {
+        t     = until;
+        event = 0;
+        if (peerSending && peerByteEnd <= t) t = peerByteEnd, event = 1;
+        if (txActive && txEnd <= t) t = txEnd, event = 2;
+        if (idleArmed && idleAt <= t) t = idleAt, event = 3;
+        now = t;
+        syncPCA();
+        switch (event) {
+            case 0:
+                if (cpuFree) dispatch();
+                return;
+            case 1:
+                if (RI) {
+                    overruns++;
+                } else {
+                    SBUF = peerNext;
+                    RI   = 1;
+                }
+                peerNext    = nextPeerByte(peerNext);
+                peerSending = 0;
+                peerSent++;
+                startPeerByte();
+                break;
+            case 2:
+                txActive = 0;
+                TI       = 1;
+                receiveAtPeer(txByte);
+                break;
+            case 3:
+                idleMatched = 1;
+                idleAt += 0x10000 * 12;
+                break;
+        }
+        if (cpuFree) dispatch();
+    }
+}
+
+void hostStall(uint32_t clocks)
+{
+    observe();
+    run(now + clocks, 0);
+    dispatch();
+}
+
+static void drain()
+{
+    uint8_t frame[RxRingSize];
+    uint8_t len, i;
+
+    len = takeRxFrame(frame, sizeof frame);
+    observe();
+    for (i = 0; i < len; i++) {
+        if (frame[i] != expected) mismatched++;
+        expected = nextPeerByte(frame[i]);
+        received++;
+    }
+}
+
+int main()
+{
+    uint8_t  record[16] = {0};
+    uint64_t nextWrite  = 0;
+
+    hostEraseAll();
+    initFlowControl();
+    initRxFrame(FlowBaud);
+    initCommitter();
+    erasePauseHook  = pauseRxForErase;
+    eraseResumeHook = resumeRxAfterErase;
+    peerNext = expected = ' ';
+    observe();
+    startPeerByte();
+
+    while (now < (uint64_t)RunMs * SysClockOfOneMs) {
+        if (now >= nextWrite) {
+            record[0]++;
+            requestCommit(RecordAddr, record, sizeof record, 1, 0);
+            nextWrite += (uint64_t)WriteEveryMs * SysClockOfOneMs;
+        }
+        drain();
+        stepCommit();
+        observe();
+        run(now + MainLoopClocks, 1);
+    }
+    // Stop the peer and take what is left
+    peerDone = 1;
+    while (peerSending || !isRxLineIdle() || rxHead != rxTail) {
+        drain();
+        run(now + MainLoopClocks, 1);
+    }
+
+    printf("FlowControl %d at %lu baud, %lu erases in %d ms\n", FlowControl, FlowBaud, (unsigned long)hostErases, RunMs);
+    printf("sent %lu, received %lu, overruns %lu, dropped %u, out of order %lu\n", (unsigned long)peerSent,
+           (unsigned long)received, (unsigned long)overruns, rxDropped, (unsigned long)mismatched);
+    printf("longest stop of the peer %.1f ms, throughput %.0f%% of the line\n", longestStop * 1000.0 / SysClock,
+           100.0 * peerSent * ByteClocks / now);
+    if (received != peerSent || mismatched) {
+        printf("LOST %lu bytes\n", (unsigned long)(peerSent - received));
+        return 1;
+    }
+    return 0;
+}
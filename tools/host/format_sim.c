@@ -0,0 +1,153 @@
+/*
+ * Check of the six txPut* functions of TxFormat.h against printf
+ *
+ * Each value is queued with the queue held, so nothing goes to SBUF, then
+ * read back with nextTxByte() and compared with printf. The values are 0,
+ * the powers of ten and the values next to them, 65535 and 65536, UINT32_MAX
+ * and RandomValues more from a fixed seed, each cut to the size of the
+ * function. The ring keeps wrapping as the values go through it.
+ *
+ * A value must also be refused, with nothing queued, while the ring has
+ * less room than its text.
+ *
+ *     tools/host/build.sh format_sim
+ *
+ * Exits non-zero if a text differs.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "STC/UART/TxFormat.h"
+
+#ifndef RandomValues
+#define RandomValues 200000
+#endif
+
+static unsigned failed, checks;
+
+typedef struct Format
+{
+    const char* name;
+    uint8_t (*put)(uint32_t value);
+    const char* printf;
+    uint32_t    mask;
+} Format_t;
+
+static uint8_t putHex8(uint32_t value)
+{
+    return txPutHex8(value);
+}
+
+static uint8_t putHex16(uint32_t value)
+{
+    return txPutHex16(value);
+}
+
+static uint8_t putHex32(uint32_t value)
+{
+    return txPutHex32(value);
+}
+
+static uint8_t putDec8(uint32_t value)
+{
+    return txPutDec8(value);
+}
+
+static uint8_t putDec16(uint32_t value)
+{
+    return txPutDec16(value);
+}
+
+static uint8_t putDec32(uint32_t value)
+{
+    return txPutDec32(value);
+}
+
+static const Format_t formats[] = {
+    {"txPutHex8", putHex8, "%02X", 0xFF},         {"txPutHex16", putHex16, "%04X", 0xFFFF},
+    {"txPutHex32", putHex32, "%08X", 0xFFFFFFFF}, {"txPutDec8", putDec8, "%u", 0xFF},
+    {"txPutDec16", putDec16, "%u", 0xFFFF},       {"txPutDec32", putDec32, "%u", 0xFFFFFFFF},
+};
+
+/**
+ * @brief Read back everything queued
+ */
+static unsigned drain(char* out, unsigned size)
+{
+    unsigned len = 0;
+    uint8_t  b;
+
+    while (nextTxByte(&b))
+        if (len < size - 1) out[len++] = b;
+    out[len] = '\0';
+    return len;
+}
+
+static void check(const Format_t* format, uint32_t value)
+{
+    char expected[16], got[16];
+
+    value &= format->mask;
+    snprintf(expected, sizeof expected, format->printf, value);
+    checks++;
+    if (!format->put(value)) {
+        if (failed++ < 20) printf("%s(%lu): refused\n", format->name, (unsigned long)value);
+        drain(got, sizeof got);
+        return;
+    }
+    drain(got, sizeof got);
+    if (strcmp(got, expected) && failed++ < 20)
+        printf("%s(%lu): \"%s\", printf \"%s\"\n", format->name, (unsigned long)value, got, expected);
+}
+
+/**
+ * @brief Fill the ring up to the room of the text less one, the value must be refused
+ */
+static void checkFull(const Format_t* format, uint32_t value)
+{
+    char    expected[16], got[TxRingSize + 1];
+    uint8_t tail, descTail;
+
+    value &= format->mask;
+    snprintf(expected, sizeof expected, format->printf, value);
+    while (txRingFree() >= strlen(expected))
+        txPutByte('.');
+    tail     = txRingTail;
+    descTail = txDescTail;
+    checks++;
+    if ((format->put(value) || txRingTail != tail || txDescTail != descTail) && failed++ < 20)
+        printf("%s(%lu): queued with %u bytes of room\n", format->name, (unsigned long)value, txRingFree());
+    drain(got, sizeof got);
+}
+
+int main()
+{
+    uint32_t values[64], seed = 1, power;
+    unsigned count = 0, f, i;
+
+    // Nothing goes to SBUF, nextTxByte() reads the queue
+    txHeld = 1;
+
+    values[count++] = 0;
+    for (power = 1; power <= 1000000000UL; power *= 10) {
+        values[count++] = power - 1;
+        values[count++] = power;
+        values[count++] = power + 1;
+    }
+    values[count++] = 65535;
+    values[count++] = 65536;
+    values[count++] = UINT32_MAX;
+
+    for (f = 0; f < sizeof formats / sizeof formats[0]; f++) {
+        for (i = 0; i < count; i++)
+            check(&formats[f], values[i]);
+        for (i = 0; i < RandomValues; i++) {
+            seed = seed * 1664525 + 1013904223;
+            // Spread over every length of text
+            check(&formats[f], seed >> (seed & 31));
+        }
+        for (i = 0; i < count; i++)
+            checkFull(&formats[f], values[i]);
+    }
+    printf("%u checks of the 6 functions against printf, %u failed\n", checks, failed);
+    return failed != 0;
+}
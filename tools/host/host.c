@@ -0,0 +1,42 @@
+/*
+ * EEPROM model of the host builds, triggered by the second IAP key
+ */
+#include <string.h>
+#include "STC/IAP/IAP.h"
+
+uint8_t  hostFlash[0x10000];
+uint32_t hostPrograms, hostErases;
+
+void hostEraseAll()
+{
+    memset(hostFlash, 0xFF, sizeof hostFlash);
+}
+
+__attribute__((weak)) void hostStall(uint32_t clocks)
+{
+    (void)clocks;
+}
+
+volatile uint8_t* hostIAPTrig()
+{
+    static volatile uint8_t trig;
+    static uint8_t          keys;
+    uint16_t                addr = IAP_ADDRH << 8 | IAP_ADDRL;
+
+    if (++keys & 1) return &trig;
+    switch (IAP_CMD) {
+        case 0x01: IAP_DATA = hostFlash[addr]; break;
+        case 0x02:
+            // Programming only clears bits
+            hostFlash[addr] &= IAP_DATA;
+            hostPrograms++;
+            hostStall(IAPProgramTimeUs * (SysClockOfOneMs / 1000));
+            break;
+        case 0x03:
+            memset(hostFlash + (addr & ~(IAPSectorSize - 1)), 0xFF, IAPSectorSize);
+            hostErases++;
+            hostStall(IAPEraseTimeUs * (SysClockOfOneMs / 1000));
+            break;
+    }
+    return &trig;
+}
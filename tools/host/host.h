@@ -0,0 +1,30 @@
+/*
+ * Forced include of the host builds, see build.sh
+ *
+ * IAP_TRIG is routed to a model of the EEPROM, which stalls the simulated
+ * CPU through hostStall() like the real operations do.
+ */
+#pragma once
+#include "STC/STCBase.h"
+#include "stdint.h"
+
+/**
+ * @brief Content of the EEPROM, erased by hostEraseAll()
+ */
+extern uint8_t hostFlash[0x10000];
+extern uint32_t hostPrograms, hostErases;
+
+/**
+ * @brief Erase the whole EEPROM
+ */
+void hostEraseAll();
+
+/**
+ * @brief Let time pass with interrupts held, a simulation defines it to model the stall of IAP
+ *
+ * @param clocks SysClock to let pass
+ */
+void hostStall(uint32_t clocks);
+
+volatile uint8_t* hostIAPTrig();
+#define IAP_TRIG (*hostIAPTrig())
@@ -0,0 +1,251 @@
+/*
+ * Throughput and consistency check of NorRecordLog.h against a model of a SPI NOR flash
+ *
+ * The model replaces transferSPI() and startSPITransfer() of the driver
+ * library. It decodes the commands of NorFlash.h, keeps the chip busy for
+ * NorProgramUs per page program and NorEraseUs per sector erase, and
+ * reports a command sent while busy, a program without write enable or a
+ * program that needs an erase first. A streamed payload is only shifted
+ * once spiBusy would clear, so a batch changed meanwhile shows up.
+ *
+ * The main loop appends a record whenever the log takes one, for RunMs.
+ * The log is then flushed, booted again from the chip and its newest
+ * record compared. The throughput is compared with byte-wise writeToIAP()
+ * of the same bytes, from IAPProgramTimeUs and IAPEraseTimeUs.
+ *
+ *     tools/host/build.sh nor_sim -DRecordStoreOnNor=1
+ *
+ * NorProgramUs, NorEraseUs, MainLoopClocks and RunMs could be set by -D.
+ * Exits non-zero if the model saw a violation or the record differs.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "RecordStore.h"
+
+#if !RecordStoreOnNor
+#error "Build it with -DRecordStoreOnNor=1"
+#endif
+
+// Typical times of a W25Q32
+#ifndef NorProgramUs
+#define NorProgramUs 700
+#endif
+#ifndef NorEraseUs
+#define NorEraseUs 45000
+#endif
+#ifndef MainLoopClocks
+#define MainLoopClocks 1000
+#endif
+#ifndef RunMs
+#define RunMs 5000
+#endif
+// The payload isr, see NorSPIClock
+#define SPIIsrClocks 60
+
+static uint64_t now, cpuClocks;
+
+static uint8_t  nor[NorLogAddr + NorLogSize];
+static int      selected, writeEnabled;
+static uint8_t  cmd, count;
+static uint32_t addr, programs, erases, violations;
+static uint64_t busyUntil;
+static uint8_t  page[NorPageSize];
+static uint16_t pageLen;
+
+static uint64_t payloadEnd;
+
+static void violation(const char* what)
+{
+    if (violations++ < 10) printf("violation at %.3f ms: %s\n", now * 1000.0 / SysClock, what);
+}
+
+static int isChipBusy()
+{
+    return now < busyUntil;
+}
+
+/**
+ * @brief The chip acts on a command once deselected
+ */
+static void endCommand()
+{
+    uint16_t i;
+
+    selected = 0;
+    switch (cmd) {
+        case NorCmdWriteEnable: writeEnabled = 1; break;
+        case NorCmdPageProgram:
+        case NorCmdSectorErase:
+            if (count < 4) break;
+            if (addr >= sizeof nor) {
+                violation("address out of the log");
+                break;
+            }
+            if (!writeEnabled) {
+                violation("program or erase without write enable");
+                break;
+            }
+            writeEnabled = 0;
+            if (cmd == NorCmdSectorErase) {
+                memset(nor + (addr & ~(NorSectorSize - 1)), 0xFF, NorSectorSize);
+                busyUntil = now + (uint64_t)NorEraseUs * SysClockOfOneMs / 1000;
+                erases++;
+                break;
+            }
+            for (i = 0; i < pageLen; i++) {
+                // Wraps within the page
+                uint32_t at = (addr & ~(NorPageSize - 1)) | ((addr + i) & (NorPageSize - 1));
+                if (page[i] & ~nor[at]) violation("program of a byte not erased");
+                nor[at] &= page[i];
+            }
+            busyUntil = now + (uint64_t)NorProgramUs * SysClockOfOneMs / 1000;
+            programs++;
+            break;
+    }
+}
+
+/**
+ * @brief Follow chip select, the model sets it to 2 after each byte to see it driven again
+ */
+static void syncChipSelect()
+{
+    if (selected && FlashCs == 1) endCommand();
+}
+
+static uint8_t shiftByte(uint8_t data)
+{
+    uint8_t out = 0xFF;
+
+    syncChipSelect();
+    if (FlashCs == 1) {
+        violation("transfer while deselected");
+        return out;
+    }
+    // Selected again since the last byte
+    if (FlashCs == 0) {
+        if (selected) endCommand();
+        selected = 1;
+        count    = 0;
+        addr     = 0;
+        pageLen  = 0;
+    }
+    FlashCs = 2;
+
+    if (count == 0) {
+        cmd = data;
+        if (isChipBusy() && cmd != NorCmdReadStatus) violation("command while busy");
+    } else if (count <= 3 && (cmd == NorCmdRead || cmd == NorCmdPageProgram || cmd == NorCmdSectorErase)) {
+        addr = addr << 8 | data;
+    } else {
+        switch (cmd) {
+            case NorCmdReadStatus: out = isChipBusy() ? NorStatusBusy : 0; break;
+            case NorCmdJedecId: out = count == 1 ? 0xEF : count == 2 ? 0x40 : 0x16; break;
+            case NorCmdRead:
+                out = nor[addr % sizeof nor];
+                addr++;
+                break;
+            case NorCmdPageProgram:
+                if (pageLen < NorPageSize) page[pageLen++] = data;
+                break;
+        }
+    }
+    if (count < 255) count++;
+    return out;
+}
+
+uint8_t transferSPI(uint8_t data)
+{
+    now += SPIClocksPerByte(NorSPIClock);
+    cpuClocks += SPIClocksPerByte(NorSPIClock);
+    return shiftByte(data);
+}
+
+void startSPITransfer(const uint8_t* tx, uint8_t* rx, uint16_t len, SPICallback_t onDone)
+{
+    spiTx      = tx;
+    spiRx      = rx;
+    spiLen     = len;
+    spiOnDone  = onDone;
+    spiBusy    = 1;
+    payloadEnd = now + (uint64_t)len * SPIClocksPerByte(NorSPIClock);
+    cpuClocks += (uint64_t)len * SPIIsrClocks;
+}
+
+/**
+ * @brief Shift a streamed payload once it would be done, as the SPI isr does
+ */
+static void runSPIIsr()
+{
+    uint8_t b;
+
+    if (!spiBusy || now < payloadEnd) return;
+    while (spiLen--) {
+        b = shiftByte(spiTx ? *spiTx++ : 0xFF);
+        if (spiRx) *spiRx++ = b;
+    }
+    spiBusy = 0;
+    if (spiOnDone) spiOnDone();
+    syncChipSelect();
+}
+
+static void step()
+{
+    stepRecordLog();
+    syncChipSelect();
+    now += MainLoopClocks;
+    runSPIIsr();
+}
+
+int main()
+{
+    uint8_t  record[RecordRunSize], size, first = 'a';
+    uint8_t  expected[32], got[32], expectedLen = 0, len;
+    uint32_t appended = 0, bytes = 0;
+    double   seconds, iapUs;
+
+    memset(nor, 0xFF, sizeof nor);
+    FlashCs = 1;
+    initRecordLog();
+    syncChipSelect();
+    if (!norPresent) {
+        printf("the chip was not found\n");
+        return 1;
+    }
+
+    while (now < (uint64_t)RunMs * SysClockOfOneMs) {
+        size = encodeRun(record, first, 1, 7);
+        if (appendRecordLog(record, size)) {
+            appended++;
+            bytes += size + 1;
+            expectedLen = decodeRecord(record, expected, sizeof expected);
+            first       = first == 'z' ? 'a' : first + 1;
+        }
+        step();
+    }
+    seconds = (double)now / SysClock;
+
+    // Everything appended reaches the chip
+    while (norBatches[0].len || norBatches[1].len || spiBusy || norEraseAddr != RecordLogNone || isChipBusy())
+        step();
+
+    // Boot again from the chip
+    memset(norBatches, 0, sizeof norBatches);
+    initRecordLog();
+    syncChipSelect();
+    len = readNewestRecord(got, sizeof got);
+    syncChipSelect();
+
+    iapUs = (double)bytes * IAPProgramTimeUs + (double)bytes / IAPSectorSize * IAPEraseTimeUs;
+    printf("%lu records, %lu bytes in %.1f s: %.0f bytes/s\n", (unsigned long)appended, (unsigned long)bytes, seconds,
+           bytes / seconds);
+    printf("%lu page programs, %.1f bytes each, %lu sector erases, CPU busy %.1f%%\n", (unsigned long)programs,
+           (double)bytes / programs, (unsigned long)erases, 100.0 * cpuClocks / now);
+    printf("byte-wise IAP of the same bytes: %.1f s with the CPU stalled, %.0f bytes/s at most\n", iapUs / 1e6,
+           bytes / (iapUs / 1e6));
+    if (len != expectedLen || memcmp(got, expected, len)) {
+        printf("newest record after boot differs\n");
+        return 1;
+    }
+    printf("newest record after boot matches, %u bytes\n", len);
+    return violations != 0;
+}
@@ -0,0 +1,290 @@
+/*
+ * Check of the record codec, RecordLog.h and RecordHistory.h against the EEPROM model of host.c
+ *
+ * - codec: every run encodeRun() makes reads back through decodeRun() and
+ *   decodeRecord(), a raw body and a two byte header decode, a torn header
+ *   is reported as broken
+ * - corrupt header: a torn header after the newest record ends the scan at
+ *   boot, the newest record is kept and the next append erases the sector
+ * - sector wrap: records appended past the end of the sector several
+ *   times, and history entries past the end of the ring, are found again
+ *   at boot, and sendSavedData() replays the newest one from code memory
+ * - urge while IAP is held: the LVD isr is taken at each access to EA while
+ *   a response is saved, power is lost once the main loop pass it
+ *   interrupted returns, and the response must be found at boot
+ *
+ *     tools/host/build.sh record_sim
+ *
+ * Exits non-zero if a check fails.
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "AlphaSender.h"
+
+#if RecordStoreOnNor
+#error "Build it without RecordStoreOnNor, nor_sim checks the NOR log"
+#endif
+
+// The model reaches EA directly, the firmware through hostEA()
+#undef EA
+
+static unsigned failed, checks;
+
+static int      lvdArmed, inIsr, lvdTaken;
+static uint32_t eaAccesses, lvdAt;
+
+volatile uint8_t* hostEA()
+{
+    if (lvdArmed && !inIsr && ++eaAccesses >= lvdAt && EA) {
+        lvdArmed = 0;
+        inIsr    = 1;
+        onLowVoltage();
+        inIsr    = 0;
+        lvdTaken = 1;
+    }
+    return &EA;
+}
+
+static void expect(int ok, const char* format, ...)
+{
+    va_list args;
+
+    checks++;
+    if (ok) return;
+    if (failed++ < 20) {
+        va_start(args, format);
+        vprintf(format, args);
+        va_end(args);
+        printf("\n");
+    }
+}
+
+/**
+ * @brief Reset the chip, IRAM is cleared by _sdcc_external_startup() and XRAM by the inits
+ */
+static void boot()
+{
+    EA            = 0;
+    iapHeld       = 0;
+    commitUrgent  = 0;
+    commitRushed  = 0;
+    cacheDirty    = 0;
+    recordLogBusy = 0;
+    txDescHead = txDescTail = 0;
+    txRingHead = txRingTail = 0;
+    txBusy                  = 0;
+    txUrgent                = 0;
+    // Nothing is sent, the checks read the queue
+    txHeld = 1;
+    initSoftTimer();
+    initCommitter();
+    initCache();
+    initRecordLog();
+    initHistory();
+    EA = 1;
+}
+
+static int isIdle()
+{
+    return isCommitIdle() && !historyStaged && !historyBusy;
+}
+
+static void runMainLoop()
+{
+    while (!isIdle()) {
+        stepCommit();
+        stepHistory();
+    }
+}
+
+static void expectNewest(const uint8_t* record, const char* what, unsigned n)
+{
+    uint8_t expected[64], got[64], expectedLen, len;
+
+    expectedLen = decodeRecord(record, expected, sizeof expected);
+    len         = readNewestRecord(got, sizeof got);
+    expect(len == expectedLen && !memcmp(got, expected, len), "%s %u: newest record differs", what, n);
+}
+
+static void checkCodec()
+{
+    static const uint8_t firsts[]  = {0x00, 'a', 'A', 0xFF};
+    static const uint8_t raw[]     = {3 << 1, 'x', 'y', 'z'};
+    static const uint8_t torn[][4] = {{0x80, 0x80, 0x05, 0x00}, {0xFF, 0xFF, 0xFF, 0xFF}, {0x81, 0x81, 0x01, 0x00}};
+    uint8_t              encoded[RecordRunSize], out[64], first, count, size, len, i, f, c;
+    int8_t               delta, d;
+    uint16_t             value;
+    unsigned             runs = 0;
+
+    for (f = 0; f < sizeof firsts; f++) {
+        for (d = -3; d <= 3; d++) {
+            for (c = 0; c < RecordLogMaxSize; c++) {
+                size = encodeRun(encoded, firsts[f], d, c);
+                expect(encodedRecordSize(encoded) == size, "run 0x%02X %+d x%u: size", firsts[f], d, c);
+                expect(decodeRun(encoded, &first, &delta, &count) && first == firsts[f] && count == c &&
+                           (!c || delta == d),
+                       "run 0x%02X %+d x%u: decodeRun", firsts[f], d, c);
+                len = decodeRecord(encoded, out, sizeof out);
+                expect(len == c + 1, "run 0x%02X %+d x%u: decoded %u bytes", firsts[f], d, c, len);
+                for (i = 0; i < len; i++)
+                    expect(out[i] == (uint8_t)(firsts[f] + i * d), "run 0x%02X %+d x%u: byte %u", firsts[f], d, c, i);
+                runs++;
+            }
+        }
+    }
+
+    expect(!decodeRun(raw, &first, &delta, &count), "raw body taken for a run");
+    len = decodeRecord(raw, out, sizeof out);
+    expect(len == 3 && !memcmp(out, "xyz", 3), "raw body decoded to %u bytes", len);
+    expect(getVarint((const uint8_t*)"\x81\x01", &value) == 2 && value == 129, "two byte varint");
+
+    for (i = 0; i < sizeof torn / sizeof torn[0]; i++) {
+        expect(!getVarint(torn[i], &value), "torn header %u: varint read", i);
+        expect(!encodedRecordSize(torn[i]), "torn header %u: size", i);
+        expect(!decodeRecord(torn[i], out, sizeof out), "torn header %u: decoded", i);
+    }
+    printf("codec: %u runs round trip, torn headers rejected\n", runs);
+}
+
+static void checkCorruptHeader()
+{
+    uint8_t  record[RecordRunSize], size;
+    uint32_t erases;
+    uint16_t off;
+
+    hostEraseAll();
+    boot();
+    size = encodeRun(record, 'a', 1, 4);
+    appendRecordLog(record, size);
+    runMainLoop();
+
+    // Torn while programming the header of the next record
+    off                                = recordLogFree;
+    hostFlash[RecordLogAddr + off]     = 0x80;
+    hostFlash[RecordLogAddr + off + 1] = 0x80;
+    boot();
+    expect(recordLogNewest == 0 && recordLogFree == IAPSectorSize, "corrupt header: newest %u, free %u",
+           recordLogNewest, recordLogFree);
+    expectNewest(record, "corrupt header", 0);
+
+    erases = hostErases;
+    size   = encodeRun(record, 'A', 1, 2);
+    appendRecordLog(record, size);
+    runMainLoop();
+    expect(hostErases == erases + 1 && recordLogNewest == 0, "corrupt header: next append did not erase");
+    boot();
+    expectNewest(record, "corrupt header, next append", 0);
+    printf("corrupt header: scan stops, newest record kept, next append erases\n");
+}
+
+static void checkSectorWrap()
+{
+    uint8_t  record[RecordRunSize], size, b;
+    uint16_t free;
+    uint32_t erases = hostErases;
+    unsigned i, wraps = 0, count;
+
+    hostEraseAll();
+    boot();
+    for (i = 0; wraps < 3; i++) {
+        size = encodeRun(record, i & 1 ? 'A' : 'a', 1, i % AlphabetLen);
+        free = recordLogFree;
+        expect(appendRecordLog(record, size), "sector wrap %u: append refused", i);
+        runMainLoop();
+        if (recordLogFree < free) wraps++;
+        if (recordLogFree < free || i % 37 == 0) {
+            boot();
+            expectNewest(record, "sector wrap", i);
+        }
+    }
+    expect(hostErases - erases == wraps, "sector wrap: %lu erases for %u wraps", (unsigned long)(hostErases - erases),
+           wraps);
+
+    // Replayed from the alphabet in code memory, not decoded into XRAM
+    boot();
+    sendSavedData();
+    expect(txDescs[txDescHead].src == TxFromMemory &&
+               txDescs[txDescHead].at.mem == (i & 1 ? lowerAlphabet : upperAlphabet),
+           "replay: not queued from code memory");
+    txHeld = 0;
+    for (count = 0; nextTxByte(&b); count++)
+        expect(b == (count == (i - 1) % AlphabetLen + 1 ? '\n' : (i & 1 ? 'a' : 'A') + count), "replay: byte %u", count);
+    expect(count == (i - 1) % AlphabetLen + 2, "replay: %u bytes", count);
+    printf("sector wrap: %u records over %u wraps, newest found at boot and replayed\n", i, wraps);
+
+    hostEraseAll();
+    boot();
+    for (i = 0; i < HistoryEntryCount + HistoryEntriesPerSector + 3; i++) {
+        size = encodeRun(record, 'a', 1, i % HistoryMaxPayloadSize);
+        appendHistory(record, size);
+        runMainLoop();
+    }
+    count = historyCount;
+    boot();
+    expect(historySeq == i && historyCount == count, "history wrap: seq %u count %u, %u entries kept", historySeq,
+           historyCount, count);
+    for (count = 1; count <= historyCount; count++)
+        expect(readHistorySeq((historyHead + HistoryEntryCount - count) % HistoryEntryCount) == i - count,
+               "history wrap: entry %u back", count);
+    printf("history wrap: %u entries, %u kept in order\n", i, historyCount);
+}
+
+static void checkUrgeWhileHeld()
+{
+    uint8_t  saved[RecordRunSize], record[RecordRunSize], size;
+    uint32_t programs;
+    unsigned at;
+
+    // Taken while the main loop holds IAP, left to releaseIAP()
+    hostEraseAll();
+    boot();
+    size = encodeRun(record, 'a', 1, 9);
+    cacheRecord(record, size);
+    programs = hostPrograms;
+    holdIAP();
+    inIsr = 1;
+    onLowVoltage();
+    inIsr = 0;
+    expect(hostPrograms == programs && commitUrgent, "urge while held: IAP touched while held");
+    releaseIAP();
+    expect(!commitUrgent && !iapHeld && isCommitIdle() && !cacheDirty, "urge while held: not done by releaseIAP()");
+    boot();
+    expectNewest(record, "urge while held", 0);
+
+    for (at = 1;; at++) {
+        hostEraseAll();
+        boot();
+        cacheRecord(saved, encodeRun(saved, 'A', 1, 3));
+        flushCache();
+        runMainLoop();
+
+        size = encodeRun(record, 'a', 1, at % AlphabetLen);
+        saveSentData(record, size);
+        eaAccesses = 0;
+        lvdAt      = at;
+        lvdArmed   = 1;
+        lvdTaken   = 0;
+        do {
+            stepCommit();
+            stepHistory();
+        } while (!lvdTaken && !isIdle());
+        lvdArmed = 0;
+        // Past the last access to EA of the save
+        if (!lvdTaken) break;
+        // Power is lost now
+        boot();
+        expectNewest(record, "urge at access to EA", at);
+    }
+    printf("urge while held: LVD taken at each of %u accesses to EA\n", at - 1);
+}
+
+int main()
+{
+    checkCodec();
+    checkCorruptHeader();
+    checkSectorWrap();
+    checkUrgeWhileHeld();
+    printf("%u checks, %u failed\n", checks, failed);
+    return failed != 0;
+}
@@ -0,0 +1,13 @@
+/*
+ * Forced include of record_sim.c, after host.h
+ *
+ * Each access to EA goes through hostEA(), which takes a pending LVD
+ * interrupt first if interrupts are enabled, as the core would between two
+ * instructions.
+ */
+#pragma once
+#include "stdint.h"
+
+volatile uint8_t* hostEA();
+
+#define EA (*hostEA())
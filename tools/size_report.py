@@ -0,0 +1,121 @@
+"""PlatformIO post script: code size per linked module and a budget check.
+
+The size of a module is the sum of its code space areas in its .rel
+object. The modules of libSTC are only counted if the linker pulled them
+in, as listed in the map. The build fails if the image is larger than
+custom_code_budget, which leaves room below the 16 KB of code space.
+
+It also checks a build outside PlatformIO:
+
+    tools/size_report.py .pio/build/stc12c5a16s2 .pio/build/stc12c5a16s2/firmware.hex --budget 15360
+"""
+
+import argparse
+import glob
+import os
+import re
+import sys
+
+CODE_AREAS = {"CSEG", "CONST", "HOME", "GSINIT", "GSFINAL", "XINIT", "CABS"}
+AREA_RE = re.compile(r"^A (\w+) size ([0-9A-Fa-f]+)")
+LINKED_RE = re.compile(r"\[\s*([^\]\s]+)\s*\]")
+
+
+def rel_code_size(path):
+    size = 0
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = AREA_RE.match(line)
+            if m and m.group(1) in CODE_AREAS:
+                size += int(m.group(2), 16)
+    return size
+
+
+def linked_library_members(map_path):
+    """Object files pulled from libraries, None if the map can't tell."""
+    if not os.path.isfile(map_path):
+        return None
+    members = set()
+    in_libraries = False
+    with open(map_path, errors="replace") as f:
+        for line in f:
+            if line.startswith("Libraries Linked"):
+                in_libraries = True
+                continue
+            if in_libraries:
+                if line.strip() and not line.startswith(" ") and "[" not in line:
+                    break
+                m = LINKED_RE.search(line)
+                if m:
+                    members.add(os.path.splitext(os.path.basename(m.group(1)))[0])
+    # Without the section every library module would look unused
+    return members if in_libraries else None
+
+
+def hex_size(path):
+    size = 0
+    with open(path) as f:
+        for line in f:
+            # :LLAAAATT, only data records count
+            if line.startswith(":") and line[7:9] == "00":
+                size += int(line[1:3], 16)
+    return size
+
+
+def module_sizes(build_dir, members):
+    rows = []
+    for rel in glob.glob(os.path.join(build_dir, "**", "*.rel"), recursive=True):
+        name = os.path.splitext(os.path.basename(rel))[0]
+        # Libraries are built in $BUILD_DIR/lib<hash>/
+        from_lib = os.path.relpath(rel, build_dir).split(os.sep)[0].startswith("lib")
+        if from_lib and members is not None and name not in members:
+            continue
+        rows.append((rel_code_size(rel), os.path.relpath(rel, build_dir)))
+    return rows
+
+
+def check(build_dir, image, budget, maximum):
+    """Print the report, return non-zero if the image is over budget."""
+    members = linked_library_members(os.path.splitext(image)[0] + ".map")
+    if members is None:
+        print("Warning: no map of the linked library modules, all of them are counted")
+    rows = module_sizes(build_dir, members)
+
+    print("Code size per module:")
+    for size, name in sorted(rows, reverse=True):
+        print(f"  {size:>6}  {name}")
+
+    if image.endswith((".hex", ".ihx")) and os.path.isfile(image):
+        total = hex_size(image)
+    else:
+        total = sum(size for size, _ in rows)
+    print(f"Code: {total} bytes, budget {budget}, code space {maximum}")
+    if total > budget:
+        print(f"Error: code is {total - budget} bytes over custom_code_budget")
+        return 1
+    return 0
+
+
+def report(target, source, env):
+    # target is whatever node the action is attached to, take the image from the env
+    image = env.subst("$BUILD_DIR/${PROGNAME}${PROGSUFFIX}")
+    maximum = int(env.BoardConfig().get("upload.maximum_size", 16384))
+    budget = int(env.GetProjectOption("custom_code_budget", maximum))
+    return check(env.subst("$BUILD_DIR"), image, budget, maximum)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("build_dir", help="build directory holding the .rel objects")
+    parser.add_argument("image", help="Intel hex image, its .map is looked up next to it")
+    parser.add_argument("--maximum", type=int, default=16384, help="code space (default: %(default)s)")
+    parser.add_argument("--budget", type=int, help="code budget (default: the code space)")
+    args = parser.parse_args()
+    return check(args.build_dir, args.image, args.budget or args.maximum, args.maximum)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
+else:
+    Import("env")  # noqa: F821
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}${PROGSUFFIX}", report)  # noqa: F821
@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""Fetch and decode the trace ring of include/STC/Trace.h into a timeline.
+
+The dump is 'T', the record count, then per record the event and the little
+endian PCA counter. The counter ticks every 12 clocks and wraps every 71 ms,
+the timeline unwraps it assuming consecutive records are closer than that.
+
+The timeline lists every record with its time, its gap to the previous one
+and the nesting of the open entries. The summary pairs each entry with its
+exit, e.g. TraceUART1Enter with TraceUART1Exit, and reports how long and how
+often each one ran.
+
+With FlowControl set to FlowXonXoff, the firmware drops its own XON and XOFF
+into the stream and escapes those bytes of the dump, pass --xonxoff to undo
+both.
+
+    tools/trace_decode.py /dev/ttyUSB0
+    tools/trace_decode.py /tmp/ttyWindmill --baud 115200
+    tools/trace_decode.py --file dump.bin
+"""
+
+import argparse
+import os
+import select
+import sys
+import termios
+import time
+import tty
+
+# TraceEvent_t in Trace.h, an exit is its entry + 1
+EVENTS = ["Timer0", "UART1", "ADC", "PCA", "SPI", "LVD", "IAP"]
+TRACE_MARK = 2 * len(EVENTS)
+
+XON, XOFF = 0x11, 0x13
+# FlowEscape and FlowEscapeXor in FlowControl.h
+ESCAPE, ESCAPE_XOR = 0x7D, 0x20
+
+DUMP_REQUEST = b"#"
+DUMP_MAGIC = ord("T")
+RECORD_SIZE = 3
+
+SYS_CLOCK = 11059200
+TICK_US = 12 / SYS_CLOCK * 1e6
+
+
+def event_name(event):
+    if event < TRACE_MARK:
+        return EVENTS[event // 2] + ("Exit" if event & 1 else "Enter")
+    if event == TRACE_MARK:
+        return "Mark"
+    return f"Unknown{event}"
+
+
+def unescape(data):
+    out = bytearray()
+    escaped = False
+    for b in data:
+        if escaped:
+            out.append(b ^ ESCAPE_XOR)
+            escaped = False
+        elif b == ESCAPE:
+            escaped = True
+        elif b not in (XON, XOFF):
+            out.append(b)
+    return bytes(out)
+
+
+def fetch(port, baud, timeout, xonxoff):
+    fd = os.open(port, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    attrs[4] = attrs[5] = getattr(termios, f"B{baud}")
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+    os.write(fd, DUMP_REQUEST)
+
+    data = b""
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        ready, _, _ = select.select([fd], [], [], 0.05)
+        if ready:
+            data += os.read(fd, 4096)
+        dump = unescape(data) if xonxoff else data
+        start = dump.find(bytes([DUMP_MAGIC]))
+        if start >= 0 and len(dump) > start + 1 and len(dump) >= start + 2 + dump[start + 1] * RECORD_SIZE:
+            break
+    os.close(fd)
+    return data
+
+
+def parse(data):
+    start = data.find(bytes([DUMP_MAGIC]))
+    if start < 0 or len(data) < start + 2:
+        sys.exit("no trace dump received")
+    count = data[start + 1]
+    body = data[start + 2 : start + 2 + count * RECORD_SIZE]
+    if len(body) < count * RECORD_SIZE:
+        print(f"dump truncated, {len(body) // RECORD_SIZE} of {count} records", file=sys.stderr)
+    records = []
+    ticks = 0
+    last = None
+    for i in range(0, len(body) - RECORD_SIZE + 1, RECORD_SIZE):
+        event, counter = body[i], body[i + 1] | body[i + 2] << 8
+        if last is not None:
+            ticks += (counter - last) & 0xFFFF
+        last = counter
+        records.append((ticks, event))
+    return records
+
+
+def timeline(records):
+    print(f"{'time us':>10} {'gap us':>8}  event")
+    open_events = []
+    previous = records[0][0] if records else 0
+    for ticks, event in records:
+        if event < TRACE_MARK and event & 1 and event - 1 in open_events:
+            open_events.remove(event - 1)
+        indent = "  " * len(open_events)
+        print(f"{ticks * TICK_US:>10.1f} {(ticks - previous) * TICK_US:>8.1f}  {indent}{event_name(event)}")
+        if event < TRACE_MARK and not event & 1:
+            open_events.append(event)
+        previous = ticks
+
+
+def summary(records):
+    durations = {}
+    entered = {}
+    for ticks, event in records:
+        if event >= TRACE_MARK:
+            continue
+        if not event & 1:
+            entered[event] = ticks
+        elif event - 1 in entered:
+            durations.setdefault(event - 1, []).append(ticks - entered.pop(event - 1))
+
+    span = records[-1][0] - records[0][0] if len(records) > 1 else 0
+    print(f"\n{'event':>8} {'count':>6} {'min us':>8} {'avg us':>8} {'max us':>8} {'busy %':>7}")
+    for event in sorted(durations):
+        d = durations[event]
+        busy = 100 * sum(d) / span if span else 0
+        print(
+            f"{EVENTS[event // 2]:>8} {len(d):>6} {min(d) * TICK_US:>8.1f} {sum(d) / len(d) * TICK_US:>8.1f}"
+            f" {max(d) * TICK_US:>8.1f} {busy:>7.1f}"
+        )
+    print(f"span {span * TICK_US:.1f} us over {len(records)} records")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("port", nargs="?", help="serial device or pty to request the dump from")
+    parser.add_argument("--baud", type=int, default=9600, help="baud rate (default: %(default)s)")
+    parser.add_argument("--file", help="decode a saved dump instead")
+    parser.add_argument("--save", help="save the raw dump")
+    parser.add_argument("--xonxoff", action="store_true", help="the firmware uses FlowXonXoff")
+    parser.add_argument("--timeout", type=float, default=2, help="s to wait for the dump (default: %(default)s)")
+    args = parser.parse_args()
+
+    if args.file:
+        with open(args.file, "rb") as f:
+            data = f.read()
+    elif args.port:
+        data = fetch(args.port, args.baud, args.timeout, args.xonxoff)
+    else:
+        parser.error("a port or --file is needed")
+    if args.save:
+        with open(args.save, "wb") as f:
+            f.write(data)
+
+    records = parse(unescape(data) if args.xonxoff else data)
+    timeline(records)
+    summary(records)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
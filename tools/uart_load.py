@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+"""Load generator for the UART1 protocol, against a device or tools/ucsim_pty.py.
+
+Each lowercase or uppercase request byte is answered by the alphabet up to
+that letter and a newline, see sendAlpha(). Requests are sent in frames of
+--burst bytes, a frame ends when the line stays idle for RxIdleBits
+bit-times, so frames are separated by --gap milliseconds.
+
+For every baud rate and burst size of the sweep, the tool reports the
+throughput of the answers, the latency from the end of a frame to the
+newline of each answer, and the bytes missing from the answers. The baud
+rate of the firmware is fixed by UART1Baud, unless it is built with
+UART1Autobaud: --autobaud then locks it to each rate of the sweep after a
+reset, by sending the sync byte until the firmware acks it.
+
+A capture replays recorded traffic instead of random frames, one frame per
+line as "<delay ms> <hex bytes>", e.g. "5 61 62 7a". Only letters are
+scored, other requests are left out of the capture.
+
+    tools/uart_load.py /dev/ttyUSB0 --sweep-burst 1,4,16,32 --frames 200
+    tools/uart_load.py /tmp/ttyWindmill --replay traffic.txt
+"""
+
+import argparse
+import os
+import random
+import select
+import sys
+import termios
+import threading
+import time
+import tty
+
+BAUDS = {b: getattr(termios, f"B{b}") for b in (1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200)}
+
+# Idle bit-times ending a frame, RxIdleBits in RxFrame.h
+RX_IDLE_BITS = 20
+
+# AutobaudSync and AutobaudAck in Autobaud.h
+AUTOBAUD_SYNC = b"\x55"
+AUTOBAUD_ACK = b"\n"
+
+
+def answer_size(request):
+    first = ord("a") if request >= ord("a") else ord("A")
+    return request - first + 2
+
+
+def is_letter(request):
+    return ord("a") <= request <= ord("z") or ord("A") <= request <= ord("Z")
+
+
+def open_port(path, baud, xonxoff):
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    attrs[4] = attrs[5] = BAUDS[baud]
+    if xonxoff:
+        attrs[0] |= termios.IXON
+    attrs[2] |= termios.CLOCAL | termios.CREAD
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd
+
+
+class Reader(threading.Thread):
+    """Timestamp every newline, count every byte."""
+
+    def __init__(self, fd):
+        super().__init__(daemon=True)
+        self.fd = fd
+        self.lines = []
+        self.received = 0
+        self.running = True
+
+    def run(self):
+        while self.running:
+            ready, _, _ = select.select([self.fd], [], [], 0.05)
+            if not ready:
+                continue
+            data = os.read(self.fd, 4096)
+            now = time.monotonic()
+            self.received += len(data)
+            self.lines.extend(now for b in data if b == ord("\n"))
+
+
+def lock_autobaud(fd, timeout):
+    """Send the sync byte of Autobaud.h until the ack comes back."""
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        os.write(fd, AUTOBAUD_SYNC)
+        # Longer than a byte at 1200 baud, shorter than AutobaudConfirmMs
+        ready, _, _ = select.select([fd], [], [], 0.02)
+        if ready and AUTOBAUD_ACK in os.read(fd, 64):
+            return True
+    return False
+
+
+def random_frames(count, burst, seed):
+    rng = random.Random(seed)
+    letters = b"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    return [(None, bytes(rng.choice(letters) for _ in range(burst))) for _ in range(count)]
+
+
+def read_capture(path):
+    frames = []
+    with open(path) as f:
+        for line in f:
+            fields = line.split("#")[0].split()
+            if not fields:
+                continue
+            data = bytes(b for b in bytes.fromhex("".join(fields[1:])) if is_letter(b))
+            if data:
+                frames.append((float(fields[0]) / 1000, data))
+    return frames
+
+
+def percentile(values, p):
+    if not values:
+        return float("nan")
+    values = sorted(values)
+    return values[min(len(values) - 1, int(round(p / 100 * (len(values) - 1))))]
+
+
+def run(args, baud, frames):
+    fd = open_port(args.port, baud, args.xonxoff)
+    if args.autobaud:
+        input(f"Reset the device for {baud} baud, then press enter")
+        if not lock_autobaud(fd, args.autobaud_timeout):
+            print(f"no autobaud lock at {baud}", file=sys.stderr)
+    # Drop the saved record sent at boot and anything left from the last run
+    time.sleep(0.1)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+
+    reader = Reader(fd)
+    reader.start()
+    bit_time = 1 / baud
+    gap = max(args.gap / 1000, RX_IDLE_BITS * 2 * bit_time)
+    sent = []
+    expected = 0
+    start = time.monotonic()
+
+    for delay, data in frames:
+        time.sleep(gap if delay is None else delay)
+        os.write(fd, data)
+        termios.tcdrain(fd)
+        # Latency includes the idle time ending the frame, as a real host sees it
+        end = time.monotonic()
+        for request in data:
+            sent.append(end)
+            expected += answer_size(request)
+
+    deadline = time.monotonic() + args.timeout
+    while len(reader.lines) < len(sent) and time.monotonic() < deadline:
+        time.sleep(0.01)
+    reader.running = False
+    reader.join()
+    os.close(fd)
+
+    answered = reader.lines[: len(sent)]
+    latencies = [(t - s) * 1000 for s, t in zip(sent, answered)]
+    duration = (answered[-1] if answered else time.monotonic()) - start
+    return {
+        "baud": baud,
+        "frames": len(frames),
+        "requests": len(sent),
+        "expected": expected,
+        "received": reader.received,
+        "dropped": max(0, expected - reader.received),
+        "throughput": reader.received / duration if duration > 0 else 0,
+        "p50": percentile(latencies, 50),
+        "p90": percentile(latencies, 90),
+        "p99": percentile(latencies, 99),
+        "max": max(latencies, default=float("nan")),
+        "unanswered": len(sent) - len(answered),
+    }
+
+
+def report(label, r):
+    print(
+        f"{label:>12} {r['baud']:>6} {r['frames']:>6} {r['requests']:>8} {r['received']:>8}/{r['expected']:<8}"
+        f" {r['dropped']:>7} {r['unanswered']:>6} {r['throughput']:>8.0f}"
+        f" {r['p50']:>7.1f} {r['p90']:>7.1f} {r['p99']:>7.1f} {r['max']:>7.1f}"
+    )
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("port", help="serial device or pty")
+    parser.add_argument("--sweep-baud", default="9600", help="comma separated baud rates (default: %(default)s)")
+    parser.add_argument("--sweep-burst", default="1", help="comma separated requests per frame (default: %(default)s)")
+    parser.add_argument("--frames", type=int, default=100, help="frames per run (default: %(default)s)")
+    parser.add_argument("--gap", type=float, default=5, help="min ms between frames (default: %(default)s)")
+    parser.add_argument("--replay", help="capture to replay instead of random frames")
+    parser.add_argument("--seed", type=int, default=1, help="seed of the random frames (default: %(default)s)")
+    parser.add_argument("--timeout", type=float, default=2, help="s to wait for the last answers (default: %(default)s)")
+    parser.add_argument("--autobaud", action="store_true", help="lock the firmware to each baud rate first")
+    parser.add_argument(
+        "--autobaud-timeout", type=float, default=2, help="s to send sync bytes for (default: %(default)s)"
+    )
+    parser.add_argument("--xonxoff", action="store_true", help="honour XON/XOFF from the firmware")
+    args = parser.parse_args()
+
+    bauds = [int(b) for b in args.sweep_baud.split(",")]
+    for baud in bauds:
+        if baud not in BAUDS:
+            parser.error(f"unsupported baud rate {baud}")
+
+    print(
+        f"{'run':>12} {'baud':>6} {'frames':>6} {'requests':>8} {'received/expected':>17}"
+        f" {'dropped':>7} {'lost':>6} {'B/s':>8} {'p50 ms':>7} {'p90 ms':>7} {'p99 ms':>7} {'max ms':>7}"
+    )
+    for baud in bauds:
+        if args.replay:
+            report(os.path.basename(args.replay)[:12], run(args, baud, read_capture(args.replay)))
+            continue
+        for burst in (int(b) for b in args.sweep_burst.split(",")):
+            report(f"burst {burst}", run(args, baud, random_frames(args.frames, burst, args.seed)))
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Run the firmware in ucsim with UART1 exposed as a Linux pseudo-terminal.
+
+ucsim reads and writes the simulated serial port through a file, so it gets
+the slave side of one pty pair. The host tools get the slave side of a
+second pair, and this script relays bytes between the two masters. The host
+side is also linked at --link, so its path does not change between runs.
+
+ucsim does not model BRT, build the firmware with SimBaudTimer1 set to 1 in
+include/BoardBase.h (or -DSimBaudTimer1=1) so UART1 is clocked from Timer1.
+UART1Autobaud then locks at 1200, 2400, 4800, 9600, 14400 and 28800 baud,
+the rates Timer1 can make counting SysClock/12. The 89C51R model has the PCA
+used by the RX idle timer, but no IAP: EEPROM reads return 0xFF and erases
+and programs take no time, so saveSentData() is faster than on a chip.
+Only UART1 exists in the model, UART2 can't be exposed.
+
+    tools/ucsim_pty.py .pio/build/stc12c5a16s2/firmware.hex
+    tools/uart_load.py /tmp/ttyWindmill --sweep-burst 1,4,16
+"""
+
+import argparse
+import os
+import select
+import signal
+import subprocess
+import sys
+import tty
+
+
+def open_pty():
+    """Open a raw pty pair, return (master fd, slave fd, slave path)."""
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    path = os.ttyname(slave)
+    # Keep the slave open, or the master reads EIO until someone opens it
+    return master, slave, path
+
+
+def relay(sim_master, host_master, sim):
+    while sim.poll() is None:
+        ready, _, _ = select.select([sim_master, host_master], [], [], 0.2)
+        for fd in ready:
+            try:
+                data = os.read(fd, 4096)
+            except OSError:
+                # The host tool closed its side, wait for the next one
+                continue
+            os.write(host_master if fd == sim_master else sim_master, data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("firmware", help="Intel hex image of the firmware")
+    parser.add_argument("--ucsim", default="s51", help="ucsim binary (default: %(default)s)")
+    parser.add_argument("--cpu", default="89C51R", help="ucsim CPU type, needs a PCA (default: %(default)s)")
+    parser.add_argument("--xtal", default="11.0592M", help="SysClock (default: %(default)s)")
+    parser.add_argument("--link", default="/tmp/ttyWindmill", help="symlink to the host side pty")
+    parser.add_argument("ucsim_args", nargs=argparse.REMAINDER, help="extra ucsim arguments after --")
+    args = parser.parse_args()
+
+    sim_master, sim_slave, sim_path = open_pty()
+    host_master, host_slave, host_path = open_pty()
+
+    if os.path.islink(args.link):
+        os.unlink(args.link)
+    os.symlink(host_path, args.link)
+
+    extra = [a for a in args.ucsim_args if a != "--"]
+    # -G runs the firmware right away instead of waiting for a "run" command
+    cmd = [args.ucsim, "-G", "-t", args.cpu, "-X", args.xtal, "-S", f"in={sim_path},out={sim_path}", *extra, args.firmware]
+    print(f"UART1 at {args.link} -> {host_path}", file=sys.stderr)
+    print(" ".join(cmd), file=sys.stderr)
+
+    sim = subprocess.Popen(cmd, stdin=subprocess.DEVNULL)
+    signal.signal(signal.SIGTERM, lambda *_: sim.terminate())
+    try:
+        relay(sim_master, host_master, sim)
+    except KeyboardInterrupt:
+        sim.terminate()
+    finally:
+        sim.wait()
+        os.unlink(args.link)
+        for fd in (sim_master, sim_slave, host_master, host_slave):
+            os.close(fd)
+    return sim.returncode
+
+
+if __name__ == "__main__":
+    sys.exit(main())